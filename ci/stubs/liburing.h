@@ -0,0 +1,44 @@
+#pragma once
+
+/*
+Compile-only stand-in for <liburing.h>, used with -DUDP_CLIENT_STUB_TRANSPORTS=ON.
+Declares just what IoUringTransport uses; every call fails at runtime.
+*/
+
+#include <cerrno>
+#include <cstdint>
+#include <sys/socket.h>
+
+struct io_uring_sqe {
+    uint8_t opcode;
+    int32_t fd;
+    uint64_t user_data;
+};
+
+struct io_uring_cqe {
+    uint64_t user_data;
+    int32_t res;
+    uint32_t flags;
+};
+
+struct io_uring {
+    io_uring_sqe sqe;
+};
+
+static inline int io_uring_queue_init(unsigned, io_uring*, unsigned) { return -ENOSYS; }
+static inline void io_uring_queue_exit(io_uring*) {}
+static inline int io_uring_submit(io_uring*) { return -ENOSYS; }
+static inline int io_uring_wait_cqe(io_uring*, io_uring_cqe**) { return -ENOSYS; }
+static inline void io_uring_cq_advance(io_uring*, unsigned) {}
+static inline io_uring_sqe* io_uring_get_sqe(io_uring* ring) { return &ring->sqe; }
+
+static inline void io_uring_prep_recvmsg(io_uring_sqe* sqe, int fd, msghdr*, unsigned) {
+    sqe->fd = fd;
+}
+
+static inline void io_uring_sqe_set_data64(io_uring_sqe* sqe, uint64_t data) { sqe->user_data = data; }
+static inline uint64_t io_uring_cqe_get_data64(const io_uring_cqe* cqe) { return cqe->user_data; }
+
+// Visits no completions
+#define io_uring_for_each_cqe(ring, head, cqe) \
+    for ((void)(ring), (head) = 0, (cqe) = nullptr; (cqe) != nullptr; (head)++)
@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+Compile-only stand-in for <pcap/pcap.h>, used with -DUDP_CLIENT_STUB_TRANSPORTS=ON.
+Declares just what PcapTransport uses; every capture source fails to open.
+*/
+
+#include <sys/time.h>
+#include <sys/types.h>
+
+#define PCAP_ERRBUF_SIZE 256
+#define PCAP_ERROR_BREAK -2
+#define DLT_EN10MB 1
+
+typedef unsigned int bpf_u_int32;
+typedef struct pcap pcap_t;
+
+struct pcap_pkthdr {
+    timeval ts;
+    bpf_u_int32 caplen;
+    bpf_u_int32 len;
+};
+
+static inline pcap_t* pcap_open_offline(const char*, char*) { return nullptr; }
+static inline pcap_t* pcap_open_live(const char*, int, int, int, char*) { return nullptr; }
+static inline int pcap_datalink(pcap_t*) { return -1; }
+static inline int pcap_next_ex(pcap_t*, pcap_pkthdr**, const u_char**) { return PCAP_ERROR_BREAK; }
+static inline void pcap_close(pcap_t*) {}
@@ -0,0 +1,9 @@
+#pragma once
+
+/*
+Compile-only stand-ins for the DPDK headers, used with -DUDP_CLIENT_STUB_TRANSPORTS=ON.
+Declare just what DPDKTransport uses; EAL initialisation fails at runtime.
+*/
+
+static inline int rte_eal_init(int, char**) { return -1; }
+static inline int rte_socket_id() { return 0; }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include <rte_mbuf.h>
+
+#define RTE_MAX_ETHPORTS 32
+#define RTE_ETH_RX_OFFLOAD_CHECKSUM 0x0000000e
+
+enum rte_eth_rx_mq_mode {
+    RTE_ETH_MQ_RX_NONE = 0,
+};
+
+struct rte_eth_rxmode {
+    rte_eth_rx_mq_mode mq_mode;
+    uint64_t offloads;
+};
+
+struct rte_eth_conf {
+    rte_eth_rxmode rxmode;
+};
+
+struct rte_eth_dev_info {
+    uint16_t max_rx_queues;
+    uint16_t max_tx_queues;
+};
+
+struct rte_eth_rxconf;
+struct rte_eth_txconf;
+
+static inline uint16_t rte_eth_dev_count_avail() { return 0; }
+static inline int rte_eth_dev_info_get(uint16_t, rte_eth_dev_info*) { return -1; }
+static inline int rte_eth_dev_configure(uint16_t, uint16_t, uint16_t, const rte_eth_conf*) { return -1; }
+static inline int rte_eth_dev_socket_id(uint16_t) { return 0; }
+
+static inline int rte_eth_rx_queue_setup(uint16_t, uint16_t, uint16_t, unsigned, const rte_eth_rxconf*,
+    rte_mempool*) {
+    return -1;
+}
+
+static inline int rte_eth_tx_queue_setup(uint16_t, uint16_t, uint16_t, unsigned, const rte_eth_txconf*) {
+    return -1;
+}
+
+static inline int rte_eth_dev_start(uint16_t) { return -1; }
+static inline int rte_eth_dev_stop(uint16_t) { return 0; }
+static inline int rte_eth_dev_close(uint16_t) { return 0; }
+static inline int rte_eth_promiscuous_enable(uint16_t) { return -1; }
+static inline uint16_t rte_eth_rx_burst(uint16_t, uint16_t, rte_mbuf**, uint16_t) { return 0; }
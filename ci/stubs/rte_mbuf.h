@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include <rte_eal.h>
+
+#define RTE_MBUF_DEFAULT_BUF_SIZE 2176
+
+struct rte_mempool {
+    int unused;
+};
+
+struct rte_mbuf {
+    void* buf_addr;
+    uint16_t data_off;
+    uint16_t data_len;
+};
+
+#define rte_pktmbuf_mtod(m, t) ((t)(static_cast<char*>((m)->buf_addr) + (m)->data_off))
+#define rte_pktmbuf_data_len(m) ((m)->data_len)
+
+static inline rte_mempool* rte_pktmbuf_pool_create(const char*, unsigned, unsigned, uint16_t, uint16_t, int) {
+    return nullptr;
+}
+
+static inline void rte_pktmbuf_free(rte_mbuf*) {}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+/*
+Fixed block of memory for receive-path buffers, set up completely before the first packet.
+
+The block is mapped from 2 MiB hugepages where the system has them reserved (falling back
+to transparent hugepages), locked with mlock() and written once per page, so the hot path
+never takes a page fault or a TLB miss on a fresh page. Allocation is a pointer bump;
+memory goes back only when the arena is destroyed. Once the block is used up, further
+requests spill to the upstream resource and are counted, which means the arena is
+too small.
+
+Not thread-safe: fill it during startup, or from the one thread that owns it.
+*/
+class HotPathArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    explicit HotPathArena(size_t capacity = 16 * 1024 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~HotPathArena() override;
+
+    HotPathArena(const HotPathArena&) = delete;
+    HotPathArena& operator=(const HotPathArena&) = delete;
+
+    size_t get_capacity() const { return m_capacity; }
+    size_t get_used() const { return m_used; }
+    size_t get_spill_count() const { return m_spills; }
+    bool is_huge_page_backed() const { return m_huge_pages; }
+    bool is_locked() const { return m_locked; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::byte* m_base {nullptr};
+    size_t m_capacity {0};
+    size_t m_used {0};
+    size_t m_spills {0};
+    bool m_huge_pages {false};
+    bool m_locked {false};
+    std::pmr::memory_resource* m_upstream;
+};
+
+// Destroys and frees an object created with make_from_resource()
+template <typename T>
+struct MemoryResourceDelete {
+    std::pmr::memory_resource* resource {std::pmr::get_default_resource()};
+
+    void operator()(T* object) const {
+        std::pmr::polymorphic_allocator<T>(resource).delete_object(object);
+    }
+};
+
+template <typename T>
+using MemoryResourcePtr = std::unique_ptr<T, MemoryResourceDelete<T>>;
+
+template <typename T, typename... Args>
+MemoryResourcePtr<T> make_from_resource(std::pmr::memory_resource* resource, Args&&... args) {
+    T* object = std::pmr::polymorphic_allocator<T>(resource).template new_object<T>(std::forward<Args>(args)...);
+    return MemoryResourcePtr<T>(object, MemoryResourceDelete<T> {resource});
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/*
+HDR (high dynamic range) histogram of latencies in nanoseconds.
+
+Buckets are log-linear as in HdrHistogram: every power-of-two range is split into the same
+number of linear sub-buckets, so any recorded value is kept to significant_digits decimal
+digits of precision from 1 ns up to highest_trackable. Recording is a few shifts and an
+increment. Larger values are clamped to highest_trackable and counted as saturated.
+*/
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(uint64_t highest_trackable = 60'000'000'000, int significant_digits = 3);
+
+    void record(uint64_t value) {
+        if (value > m_highest_trackable) {
+            value = m_highest_trackable;
+            m_saturated++;
+        }
+
+        m_counts[get_counts_index(value)]++;
+        m_total_count++;
+        m_total_sum += value;
+        m_min = value < m_min ? value : m_min;
+        m_max = value > m_max ? value : m_max;
+    }
+
+    // Adds every value recorded in other, which must have the same layout
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    // Highest value that percentile (0-100) of the recorded values are at or below
+    uint64_t get_value_at_percentile(double percentile) const;
+
+    uint64_t get_total_count() const { return m_total_count; }
+    uint64_t get_saturated_count() const { return m_saturated; }
+    uint64_t get_min() const { return m_total_count ? m_min : 0; }
+    uint64_t get_max() const { return m_max; }
+    double get_mean() const;
+
+    // One line per standard percentile, values converted to microseconds
+    void print_percentiles(std::ostream& out) const;
+
+private:
+    // Bucket 0 covers [0, sub_bucket_count) at unit resolution; bucket b doubles the range and step
+    size_t get_counts_index(uint64_t value) const {
+        int bucket = 63 - __builtin_clzll(value | m_sub_bucket_mask) - m_sub_bucket_half_count_magnitude;
+        uint64_t sub_bucket = value >> bucket;
+
+        return (static_cast<size_t>(bucket + 1) << m_sub_bucket_half_count_magnitude)
+            + static_cast<size_t>(sub_bucket) - m_sub_bucket_half_count;
+    }
+
+    uint64_t get_highest_equivalent_value(size_t index) const;
+
+    uint64_t m_highest_trackable;
+    int m_sub_bucket_half_count_magnitude;
+    size_t m_sub_bucket_half_count;
+    uint64_t m_sub_bucket_mask;
+    std::vector<uint64_t> m_counts;
+
+    uint64_t m_total_count {0};
+    uint64_t m_total_sum {0};
+    uint64_t m_saturated {0};
+    uint64_t m_min {UINT64_MAX};
+    uint64_t m_max {0};
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <MoldUDPParser.hpp>
+#include <MoldUDPProtocol.hpp>
+
+// Location of the instrument key inside each message: a big-endian field 1 to 4 bytes wide
+struct MessageKeyField {
+    uint16_t offset;
+    uint8_t width;
+};
+
+// ITCH 5.0 puts the 2-byte stock locate right after the message type
+constexpr MessageKeyField ITCH_STOCK_LOCATE {1, 2};
+
+// Key of a message too short to contain the key field
+constexpr uint32_t NO_MESSAGE_KEY = UINT32_MAX;
+
+[[gnu::always_inline]] inline uint32_t read_message_key(const uint8_t* message, size_t length, MessageKeyField field) {
+    if (static_cast<size_t>(field.offset) + field.width > length) {
+        return NO_MESSAGE_KEY;
+    }
+
+    const uint8_t* field_data = message + field.offset;
+
+    switch (field.width) {
+    case 1:
+        return field_data[0];
+    case 2:
+        return (uint32_t(field_data[0]) << 8) | field_data[1];
+    case 3:
+        return (uint32_t(field_data[0]) << 16) | (uint32_t(field_data[1]) << 8) | field_data[2];
+    default:
+        return (uint32_t(field_data[0]) << 24) | (uint32_t(field_data[1]) << 16)
+            | (uint32_t(field_data[2]) << 8) | field_data[3];
+    }
+}
+
+/*
+Structure-of-arrays index over every message in a burst of packets.
+Each column is contiguous so that filters can run vectorised over a whole burst before
+any per-message handler is called. Messages are not copied: the message column points into
+the transport's receive buffers, which stay valid until the burst ends.
+The key column holds an instrument id, by default the ITCH stock locate.
+Columns are allocated from memory (e.g. a HotPathArena) and only ever grow.
+*/
+class MoldUDPMessageBatch {
+public:
+    explicit MoldUDPMessageBatch(MessageKeyField key_field = ITCH_STOCK_LOCATE,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Changes which message field fills the key column; takes effect from the next packet
+    void set_key_field(MessageKeyField key_field);
+
+    void clear() { m_size = 0; }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    std::span<const uint8_t* const> get_message_data() const { return {m_messages.data(), m_size}; }
+    std::span<const uint16_t> get_lengths() const { return {m_lengths.data(), m_size}; }
+    std::span<const uint64_t> get_sequence_numbers() const { return {m_sequences.data(), m_size}; }
+    std::span<const uint8_t> get_message_types() const { return {m_types.data(), m_size}; }
+    std::span<const uint32_t> get_keys() const { return {m_keys.data(), m_size}; }
+
+    std::string_view get_message(size_t i) const {
+        return std::string_view(reinterpret_cast<const char*>(m_messages[i]), m_lengths[i]);
+    }
+
+    /*
+    Walk the length prefixes of one packet once, validating them against the packet length,
+    and append a row per admitted message. Returns an error description or nullptr.
+    Messages before a malformed length prefix are kept.
+    */
+    template <MoldUDPSequencer Sequencer>
+    [[gnu::always_inline]] const char* index_packet(const uint8_t* payload, size_t length, Sequencer& sequencer) {
+        if (length < sizeof(MoldUDP64PacketHeader)) {
+            return "Packet too small for MoldUDP header";
+        }
+
+        const MoldUDP64PacketHeader* session_header =
+            reinterpret_cast<const MoldUDP64PacketHeader*>(payload);
+        uint16_t msg_count = session_header->get_message_count();
+
+        if (msg_count == MOLD_UDP_END_OF_SESSION) {
+            return nullptr;
+        }
+
+        uint64_t first_sequence = session_header->get_sequence_number();
+        uint16_t skip = std::min(sequencer.admit(first_sequence, msg_count), msg_count);
+
+        // Grow every column once per packet so the walk is plain stores
+        if (m_size + msg_count - skip > m_messages.size()) {
+            reserve_rows(m_size + msg_count - skip);
+        }
+
+        // One copy of the walk per key width, so the key read inside it is a fixed-size load
+        switch (m_key_field.width) {
+        case 1:
+            return index_messages<1>(payload, length, first_sequence, msg_count, skip);
+        case 2:
+            return index_messages<2>(payload, length, first_sequence, msg_count, skip);
+        case 3:
+            return index_messages<3>(payload, length, first_sequence, msg_count, skip);
+        default:
+            return index_messages<4>(payload, length, first_sequence, msg_count, skip);
+        }
+    }
+
+private:
+    template <int KeyWidth>
+    [[gnu::always_inline]] const char* index_messages(const uint8_t* payload, size_t length,
+        uint64_t first_sequence, uint16_t msg_count, uint16_t skip) {
+        size_t offset = sizeof(MoldUDP64PacketHeader);
+
+        // Messages the sequencer has already seen are only validated
+        for (uint16_t i = 0; i < skip; i++) {
+            if (offset + sizeof(MoldUDP64MessageHeader) > length) {
+                return "Incomplete message header";
+            }
+
+            offset += sizeof(MoldUDP64MessageHeader)
+                + reinterpret_cast<const MoldUDP64MessageHeader*>(payload + offset)->get_message_length();
+
+            if (offset > length) {
+                return "Incomplete message data";
+            }
+        }
+
+        // Local column pointers: the uint8_t type column could otherwise alias every other store
+        const uint8_t** __restrict messages = m_messages.data();
+        uint16_t* __restrict lengths = m_lengths.data();
+        uint64_t* __restrict sequences = m_sequences.data();
+        uint8_t* __restrict types = m_types.data();
+        uint32_t* __restrict keys = m_keys.data();
+        const size_t key_offset = m_key_field.offset;
+        const uint64_t sequence_base = first_sequence + skip - m_size; // Sequence number of row 0
+        const size_t end_row = m_size + (msg_count - skip);
+        size_t row = m_size;
+
+        for (; row < end_row; row++) {
+            if (offset + sizeof(MoldUDP64MessageHeader) > length) {
+                m_size = row;
+                return "Incomplete message header";
+            }
+
+            uint16_t msg_len = reinterpret_cast<const MoldUDP64MessageHeader*>(payload + offset)->get_message_length();
+            const uint8_t* message = payload + offset + sizeof(MoldUDP64MessageHeader);
+            offset += sizeof(MoldUDP64MessageHeader) + msg_len;
+
+            if (offset > length) {
+                m_size = row;
+                return "Incomplete message data";
+            }
+
+            // Type and key come from the same cache line, read while the walk moves on
+            uint8_t type = 0;
+            uint32_t key = NO_MESSAGE_KEY;
+
+            if (msg_len >= key_offset + KeyWidth) [[likely]] {
+                type = message[0];
+                key = load_key<KeyWidth>(message + key_offset);
+            } else if (msg_len > 0) {
+                type = message[0];
+            }
+
+            messages[row] = message;
+            lengths[row] = msg_len;
+            sequences[row] = sequence_base + row;
+            types[row] = type;
+            keys[row] = key;
+        }
+
+        m_size = row;
+        return nullptr;
+    }
+
+    // Big-endian field of KeyWidth bytes
+    template <int KeyWidth>
+    [[gnu::always_inline]] static uint32_t load_key(const uint8_t* field_data) {
+        if constexpr (KeyWidth == 1) {
+            return field_data[0];
+        } else if constexpr (KeyWidth == 2) {
+            return (uint32_t(field_data[0]) << 8) | field_data[1];
+        } else if constexpr (KeyWidth == 3) {
+            return (uint32_t(field_data[0]) << 16) | (uint32_t(field_data[1]) << 8) | field_data[2];
+        } else {
+            return (uint32_t(field_data[0]) << 24) | (uint32_t(field_data[1]) << 16)
+                | (uint32_t(field_data[2]) << 8) | field_data[3];
+        }
+    }
+
+    void reserve_rows(size_t rows);
+
+    MessageKeyField m_key_field;
+    size_t m_size {0};
+    // Columns are sized to capacity; only the first m_size rows are meaningful
+    std::pmr::vector<const uint8_t*> m_messages; // Start of the message payload within its packet
+    std::pmr::vector<uint16_t> m_lengths;
+    std::pmr::vector<uint64_t> m_sequences;
+    std::pmr::vector<uint8_t> m_types; // First payload byte (the ITCH message type), 0 for empty messages
+    std::pmr::vector<uint32_t> m_keys; // Instrument key read from m_key_field, or NO_MESSAGE_KEY
+};
+
+// A handler that consumes whole indexed bursts instead of one message at a time
+template <typename H>
+concept MoldUDPBatchHandler = requires(H handler, const MoldUDPMessageBatch& batch) {
+    handler.on_batch(batch);
+    handler.on_error("");
+};
+
+/*
+Selection kernels over the batch columns.
+Each writes the row numbers of matching messages to selection (which must have room for
+batch.size() entries) and returns how many matched.
+*/
+size_t select_by_type(const MoldUDPMessageBatch& batch, uint8_t type, uint32_t* selection);
+
+// types is a 256-entry membership table indexed by message type byte
+size_t select_by_types(const MoldUDPMessageBatch& batch, const bool (&types)[256], uint32_t* selection);
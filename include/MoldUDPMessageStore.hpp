@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include <MoldUDPProtocol.hpp>
+
+/*
+Sequenced message store backing the rewinder.
+Messages are kept back to back in MoldUDP64 message block format (big-endian length
+prefix followed by the payload), the same layout as on the wire, with an offset index
+for random access by sequence number.
+
+The store is either built in memory with append(), or memory-mapped read-only from a
+file of message blocks (e.g. one written by save()).
+*/
+class MoldUDPMessageStore {
+public:
+    explicit MoldUDPMessageStore(uint64_t first_sequence = 1);
+    MoldUDPMessageStore(const char* path, uint64_t first_sequence = 1);
+    ~MoldUDPMessageStore();
+
+    MoldUDPMessageStore(const MoldUDPMessageStore&) = delete;
+    MoldUDPMessageStore& operator=(const MoldUDPMessageStore&) = delete;
+
+    void append(std::string_view message);
+    void save(const char* path) const;
+
+    // Sequence number of the first stored message and one past the last
+    uint64_t get_first_sequence_number() const { return m_first_sequence; }
+    uint64_t get_end_sequence_number() const { return m_first_sequence + m_offsets.size(); }
+
+    bool contains(uint64_t sequence) const {
+        return sequence >= m_first_sequence && sequence < get_end_sequence_number();
+    }
+
+    // The caller must check contains() first
+    std::string_view get(uint64_t sequence) const {
+        const uint8_t* block = data() + m_offsets[sequence - m_first_sequence];
+        const MoldUDP64MessageHeader* msg_header = reinterpret_cast<const MoldUDP64MessageHeader*>(block);
+
+        return std::string_view(reinterpret_cast<const char*>(block + sizeof(MoldUDP64MessageHeader)),
+            msg_header->get_message_length());
+    }
+
+private:
+    const uint8_t* data() const { return m_mapped ? m_mapped : m_owned.data(); }
+
+    uint64_t m_first_sequence;
+    std::vector<uint64_t> m_offsets;
+    std::vector<uint8_t> m_owned;
+    const uint8_t* m_mapped {nullptr};
+    size_t m_mapped_size {0};
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <string_view>
+
+#include <MoldUDPProtocol.hpp>
+
+/*
+Policy requirements for MoldUDPReceiver.
+
+A Sequencer decides which messages of a packet are new. admit() is given the first sequence
+number and message count of a packet and returns how many leading messages to skip
+(e.g. because they were already delivered by an earlier packet).
+
+A Handler receives the parse events. Everything is called inline from the receive loop,
+so handlers should do as little work as possible.
+*/
+template <typename S>
+concept MoldUDPSequencer = requires(S sequencer, uint64_t sequence, uint16_t count) {
+    { sequencer.admit(sequence, count) } -> std::convertible_to<uint16_t>;
+};
+
+template <typename H>
+concept MoldUDPHandler = requires(H handler, const sockaddr_in& sender, size_t length,
+    const MoldUDP64PacketHeader& header, uint64_t sequence, std::string_view message) {
+    handler.on_datagram(sender, length);
+    handler.on_packet(header);
+    handler.on_message(sequence, message);
+    handler.on_error("");
+};
+
+// Optional on any handler: told when the receiver starts (true) and stops feeding it warm-up packets
+template <typename H>
+concept MoldUDPWarmUpHandler = requires(H handler) {
+    handler.on_warm_up(true);
+};
+
+/*
+The single MoldUDP64 parse core shared by every transport.
+Forced inline so that each MoldUDPReceiver instantiation compiles down to one flat loop
+with the sequencer and handler calls folded in.
+*/
+template <MoldUDPSequencer Sequencer, MoldUDPHandler Handler>
+[[gnu::always_inline]] inline void parse_mold_packet(const uint8_t* payload, size_t length,
+    const sockaddr_in& sender, Sequencer& sequencer, Handler& handler) {
+
+    handler.on_datagram(sender, length);
+
+    if (length < sizeof(MoldUDP64PacketHeader)) {
+        handler.on_error("Packet too small for MoldUDP header");
+        return;
+    }
+
+    const MoldUDP64PacketHeader* session_header =
+        reinterpret_cast<const MoldUDP64PacketHeader*>(payload);
+
+    handler.on_packet(*session_header);
+
+    uint16_t msg_count = session_header->get_message_count();
+
+    if (msg_count == MOLD_UDP_END_OF_SESSION) {
+        return;
+    }
+
+    uint64_t first_sequence = session_header->get_sequence_number();
+    uint16_t skip = sequencer.admit(first_sequence, msg_count);
+    size_t offset = sizeof(MoldUDP64PacketHeader);
+
+    for (uint16_t i = 0; i < msg_count; i++) {
+        if (offset + sizeof(MoldUDP64MessageHeader) > length) {
+            handler.on_error("Incomplete message header");
+            break;
+        }
+
+        const MoldUDP64MessageHeader* msg_header =
+            reinterpret_cast<const MoldUDP64MessageHeader*>(payload + offset);
+        offset += sizeof(MoldUDP64MessageHeader);
+
+        uint16_t msg_len = msg_header->get_message_length();
+
+        if (offset + msg_len > length) {
+            handler.on_error("Incomplete message data");
+            break;
+        }
+
+        if (i >= skip) {
+            // Zero-copy: the view points straight into the transport's receive buffer
+            handler.on_message(first_sequence + i,
+                std::string_view(reinterpret_cast<const char*>(payload + offset), msg_len));
+        }
+
+        offset += msg_len;
+    }
+}
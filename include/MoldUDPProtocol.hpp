@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstddef>
+#include <cstdint>
+#include <endian.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr size_t MAX_PACKET_SIZE = 1400;
+constexpr size_t MOLD_UDP_SESSION_LENGTH = 10;
+
+// A message count of 0xFFFF marks the end of the session; such packets carry no messages
+constexpr uint16_t MOLD_UDP_END_OF_SESSION = 0xFFFF;
+
+struct MoldUDP64PacketHeader {
+    // All multi-byte integer fields are in network byte order (big-endian)
+    char m_session[MOLD_UDP_SESSION_LENGTH]; // Alphanumeric session to which the packet belongs
+    uint64_t m_sequence_number; // Sequence number of the first message in the packet
+    uint16_t m_message_count; // The count of messages in the packet
+
+    std::string get_session() const {
+        return std::string(m_session, MOLD_UDP_SESSION_LENGTH);
+    }
+
+    void set_session(std::string_view session) {
+        std::fill(std::begin(m_session), std::end(m_session), ' '); // Any unused bytes are space-padded as per spec
+        std::copy_n(session.data(), std::min(session.size(), MOLD_UDP_SESSION_LENGTH), m_session);
+    }
+
+    uint64_t get_sequence_number() const {
+        return be64toh(m_sequence_number);
+    }
+
+    void set_sequence_number(uint64_t seq_num) {
+        m_sequence_number = htobe64(seq_num);
+    }
+
+    uint16_t get_message_count() const {
+        return ntohs(m_message_count);
+    }
+
+    void set_message_count(uint16_t msg_count) {
+        m_message_count = htons(msg_count);
+    }
+
+} __attribute__((packed));
+
+struct MoldUDP64MessageHeader {
+    uint16_t message_length; // Length in bytes of the message block, excluding this header
+
+    uint16_t get_message_length() const {
+        return ntohs(message_length);
+    }
+
+    void set_message_length(uint16_t len) {
+        message_length = htons(len);
+    }
+} __attribute__((packed));
+
+/*
+Packs messages into a single MoldUDP64 packet.
+Used wherever we need to produce packets ourselves (benchmarks, local testing) rather than parse them.
+*/
+class MoldUDPPacketBuilder {
+public:
+    MoldUDPPacketBuilder(std::string_view session, uint64_t first_sequence, size_t max_size = MAX_PACKET_SIZE);
+
+    // Returns false (and leaves the packet untouched) if the message would not fit
+    bool add_message(std::string_view message);
+
+    // Start a new packet whose first message has the given sequence number
+    void reset(uint64_t first_sequence);
+
+    uint64_t get_next_sequence_number() const;
+    uint16_t get_message_count() const;
+    size_t get_size() const;
+
+    std::span<const uint8_t> get_packet() const;
+
+private:
+    MoldUDP64PacketHeader& header();
+
+    std::vector<uint8_t> m_buffer;
+    size_t m_max_size;
+    uint64_t m_first_sequence;
+    uint16_t m_message_count {0};
+};
@@ -1,43 +1,200 @@
 #pragma once
 
+#include <arpa/inet.h>
+#include <cstdint>
+#include <memory_resource>
 #include <netinet/in.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-#include <UDPSocket.hpp>
+#include <MoldUDPMessageBatch.hpp>
+#include <MoldUDPParser.hpp>
+#include <MoldUDPProtocol.hpp>
+#include <MoldUDPTransports.hpp>
 
-struct MoldUDP64PacketHeader {
-    // All multi-byte integer fields are in network byte order (big-endian)
-    char m_session[10]; // Alphanumeric session to which the packet belongs
-    uint64_t m_sequence_number; // Sequence number of the first message in the packet
-    uint16_t m_message_count; // The count of messages in the packet
+// Delivers every message, including duplicates
+struct NullSequencer {
+    uint16_t admit(uint64_t, uint16_t) {
+        return 0;
+    }
+};
 
-    std::string get_session() const;
-    void set_session(std::string_view session);
+// Drops messages that were already delivered and counts the ones that never arrived
+class GapDetectingSequencer {
+public:
+    uint16_t admit(uint64_t sequence, uint16_t count) {
+        if (m_expected == 0) { // Sequence numbers start at 1, so 0 means we have not synced yet
+            m_expected = sequence + count;
+            return 0;
+        }
+
+        if (sequence > m_expected) {
+            m_gap_count++;
+            m_missed_messages += sequence - m_expected;
+            m_expected = sequence + count;
+            return 0;
+        }
+
+        uint64_t end = sequence + count;
+
+        if (end <= m_expected) {
+            return count;
+        }
+
+        uint16_t skip = static_cast<uint16_t>(m_expected - sequence);
+        m_expected = end;
+        return skip;
+    }
+
+    uint64_t get_expected_sequence_number() const { return m_expected; }
+    uint64_t get_gap_count() const { return m_gap_count; }
+    uint64_t get_missed_message_count() const { return m_missed_messages; }
+
+private:
+    uint64_t m_expected {0};
+    uint64_t m_gap_count {0};
+    uint64_t m_missed_messages {0};
+};
+
+// Prints every packet and message to stdout, except during warm-up
+class PrintingHandler {
+public:
+    void on_datagram(const sockaddr_in& sender, size_t length);
+    void on_packet(const MoldUDP64PacketHeader& header);
+    void on_message(uint64_t sequence, std::string_view message);
+    void on_error(const char* what);
+    void on_warm_up(bool active) { m_warming_up = active; }
+
+private:
+    int m_message_index {0};
+    bool m_warming_up {false};
+};
+
+// Session name of the synthetic packets used to warm up a receiver
+constexpr std::string_view MOLD_UDP_WARM_UP_SESSION = "WARMUP";
 
-    uint64_t get_sequence_number() const;
-    void set_sequence_number(uint64_t seq_num);
+// Warm-up passes over make_warm_up_packets() run by MoldUDPReceiver::start()
+constexpr size_t MOLD_UDP_WARM_UP_ROUNDS = 64;
 
-    uint16_t get_message_count() const;
-    void set_message_count(uint16_t msg_count);
+// ITCH-shaped synthetic packets (mixed message types and stock locates) for warming up a receiver
+std::vector<std::vector<uint8_t>> make_warm_up_packets(size_t packet_count = 4 * RECEIVE_BATCH_SIZE);
 
-} __attribute__((packed));
+template <typename H>
+concept MoldUDPReceiverHandler = MoldUDPHandler<H> || MoldUDPBatchHandler<H>;
 
-struct MoldUDP64MessageHeader {
-    uint16_t message_length; // Length in bytes of the message block, excluding this header
+/*
+MoldUDP64 receiver assembled from a Transport, a Sequencer and a Handler policy.
+All three are held by value and the hot path is templated, so a receive_and_process()
+call compiles to the transport's receive loop with the parse core and handler inlined.
 
-    uint16_t get_message_length() const;
-    void set_message_length(uint16_t len);
-} __attribute__((packed));
+A per-message handler is called as each packet is parsed. A batch handler instead gets
+one structure-of-arrays index of every message in the burst. The batch path is experimental:
+indexing costs more than it saves, so per-message handlers are the default and the faster choice.
 
+start() gets a receiver ready for its first packet: it runs synthetic packets through the
+same inlined receive path, then joins the multicast group. Warm-up is opt-in: only handlers
+that implement on_warm_up() get the synthetic packets, so it can never pass fake messages
+to a handler that would take them for market data. Together with a HotPathArena
+passed as memory (for the batch columns) and to the transport (for its receive buffers),
+nothing on the receive path is first touched by a real packet.
+*/
+template <typename Transport, MoldUDPSequencer Sequencer = NullSequencer, MoldUDPReceiverHandler Handler = PrintingHandler>
 class MoldUDPReceiver {
 public:
-    MoldUDPReceiver(const char* multicast_addr, int port, const char* interface_addr = nullptr);
+    explicit MoldUDPReceiver(Transport transport, Sequencer sequencer = {}, Handler handler = {},
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource())
+        : m_transport(std::move(transport))
+        , m_sequencer(std::move(sequencer))
+        , m_handler(std::move(handler))
+        , m_batch(ITCH_STOCK_LOCATE, memory) {}
 
-    void receive_and_process();
+    void receive_and_process() {
+        m_transport.poll(
+            [this](const uint8_t* payload, size_t length, const sockaddr_in& sender) {
+                process_datagram(payload, length, sender);
+            },
+            [this] { end_burst(); });
+    }
 
-    const std::string& get_multicast_address() const;
+    /*
+    Feed packets through the receive path rounds times, in bursts of RECEIVE_BATCH_SIZE.
+    The sequencer is left as it was. The handler sees the messages between on_warm_up(true)
+    and on_warm_up(false), which is why it has to implement it.
+    */
+    void warm_up(const std::vector<std::vector<uint8_t>>& packets, size_t rounds)
+        requires MoldUDPWarmUpHandler<Handler> {
+        Sequencer sequencer = m_sequencer;
+        sockaddr_in sender {};
+        sender.sin_family = AF_INET;
+        sender.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        m_handler.on_warm_up(true);
+
+        for (size_t round = 0; round < rounds; round++) {
+            for (size_t i = 0; i < packets.size(); i++) {
+                process_datagram(packets[i].data(), packets[i].size(), sender);
+
+                if ((i + 1) % RECEIVE_BATCH_SIZE == 0 || i + 1 == packets.size()) {
+                    end_burst();
+                }
+            }
+        }
+
+        m_handler.on_warm_up(false);
+        m_sequencer = std::move(sequencer);
+    }
+
+    // Warm up if the handler supports it, then join the multicast group on transports that have one
+    void start(size_t warm_up_rounds = MOLD_UDP_WARM_UP_ROUNDS) {
+        if constexpr (MoldUDPWarmUpHandler<Handler>) {
+            warm_up(make_warm_up_packets(), warm_up_rounds);
+        }
+
+        if constexpr (requires { m_transport.join(); }) {
+            m_transport.join();
+        }
+    }
+
+    const std::string& get_multicast_address() const {
+        return m_transport.get_multicast_address();
+    }
+
+    Transport& get_transport() { return m_transport; }
+    Sequencer& get_sequencer() { return m_sequencer; }
+    Handler& get_handler() { return m_handler; }
+
+    // Batch handlers only: e.g. to pick which message field fills the key column
+    MoldUDPMessageBatch& get_batch() requires MoldUDPBatchHandler<Handler> { return m_batch; }
 
 private:
-    UDPSocket m_socket;
-    std::string m_multicast_addr {};
-    sockaddr_in m_local_addr {};
-};
\ No newline at end of file
+    struct NoBatch {
+        NoBatch(MessageKeyField, std::pmr::memory_resource*) {}
+    };
+
+    [[gnu::always_inline]] void process_datagram(const uint8_t* payload, size_t length, const sockaddr_in& sender) {
+        if constexpr (MoldUDPBatchHandler<Handler>) {
+            if (const char* error = m_batch.index_packet(payload, length, m_sequencer)) {
+                m_handler.on_error(error);
+            }
+        } else {
+            parse_mold_packet(payload, length, sender, m_sequencer, m_handler);
+        }
+    }
+
+    [[gnu::always_inline]] void end_burst() {
+        if constexpr (MoldUDPBatchHandler<Handler>) {
+            if (!m_batch.empty()) {
+                m_handler.on_batch(m_batch);
+            }
+            m_batch.clear();
+        }
+    }
+
+    Transport m_transport;
+    Sequencer m_sequencer;
+    Handler m_handler;
+    [[no_unique_address]] std::conditional_t<MoldUDPBatchHandler<Handler>, MoldUDPMessageBatch, NoBatch> m_batch;
+};
@@ -11,34 +11,69 @@
 
 #include <MoldUDPReceiver.hpp>
 
-class MoldUDPReceiverDPDK {
+/*
+Polls a DPDK port in bursts and hands each matching UDP payload on zero-copy from the mbuf.
+The mbuf pool lives in DPDK's hugepage memory. The port is configured on construction but
+only started by join(), so the receiver can warm up before the first frame arrives.
+*/
+class DPDKTransport {
 public:
-    MoldUDPReceiverDPDK(const char* multicast_addr, int port, const char* interface_addr = nullptr);
-    ~MoldUDPReceiverDPDK();
-    
-    void receive_and_process();
+    DPDKTransport(const char* multicast_addr, int port, const char* interface_addr = nullptr);
+    ~DPDKTransport();
+
+    DPDKTransport(const DPDKTransport&) = delete;
+    DPDKTransport& operator=(const DPDKTransport&) = delete;
+
+    DPDKTransport(DPDKTransport&& other) noexcept;
+    DPDKTransport& operator=(DPDKTransport&& other) = delete;
+
+    template <typename OnDatagram, typename OnBurstEnd = NoBurstEnd>
+    [[gnu::always_inline]] void poll(OnDatagram&& on_datagram, OnBurstEnd&& on_burst_end = {}) {
+        rte_mbuf* bufs[BURST_SIZE];
+
+        const uint16_t nb_rx = rte_eth_rx_burst(m_dpdk_port_id, 0, bufs, BURST_SIZE);
+
+        for (uint16_t i = 0; i < nb_rx; i++) {
+            UDPDatagramView datagram;
+
+            if (extract_udp_datagram(rte_pktmbuf_mtod(bufs[i], const uint8_t*), rte_pktmbuf_data_len(bufs[i]),
+                    m_multicast_ip, m_port, datagram)) {
+                on_datagram(datagram.payload, datagram.length, datagram.sender);
+            }
+        }
+
+        on_burst_end();
+
+        for (uint16_t i = 0; i < nb_rx; i++) {
+            rte_pktmbuf_free(bufs[i]);
+        }
+    }
+
+    // Starts the port and its multicast filtering; further calls do nothing
+    void join();
+
     const std::string& get_multicast_address() const;
-    
+
     // DPDK-specific initialization
     static void init_dpdk(int argc, char** argv);
-    
+
 private:
     void setup_port();
     void configure_multicast();
-    void process_packet(rte_mbuf* mbuf);
-    void parse_mold_packet(const uint8_t* payload, size_t length, 
-                          uint32_t src_ip, uint16_t src_port);
-    
+
     std::string m_multicast_addr;
-    uint16_t m_port;
+    uint16_t m_port; // Network byte order
     uint16_t m_dpdk_port_id;
-    uint32_t m_multicast_ip;
-    
+    uint32_t m_multicast_ip; // Network byte order
+    bool m_started {false};
+
     rte_mempool* m_mbuf_pool;
-    
+
     static constexpr uint16_t RX_RING_SIZE = 1024;
     static constexpr uint16_t TX_RING_SIZE = 1024;
     static constexpr uint16_t NUM_MBUFS = 8191;
     static constexpr uint16_t MBUF_CACHE_SIZE = 250;
     static constexpr uint16_t BURST_SIZE = 32;
-};
\ No newline at end of file
+};
+
+using MoldUDPReceiverDPDK = MoldUDPReceiver<DPDKTransport>;
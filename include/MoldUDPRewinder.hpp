@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <unordered_map>
+#include <vector>
+
+#include <MoldUDPMessageStore.hpp>
+#include <MoldUDPProtocol.hpp>
+#include <UDPSocket.hpp>
+
+struct MoldUDPRewinderConfig {
+    std::string session;
+    int port;
+    uint16_t max_messages_per_request {5000};
+    double client_messages_per_second {200000}; // Token bucket refill rate per requester
+    double client_burst_messages {20000}; // Token bucket capacity per requester
+    size_t max_packet_size {MAX_PACKET_SIZE};
+    std::chrono::seconds client_idle_timeout {60};
+};
+
+struct MoldUDPRewinderStats {
+    uint64_t requests {0};
+    uint64_t malformed {0}; // Wrong size or session
+    uint64_t throttled {0}; // Coalesced requests dropped entirely by the rate limiter
+    uint64_t out_of_range {0}; // Nothing requested is in the store
+    uint64_t coalesced {0}; // Requests merged into an overlapping one from the same requester
+    uint64_t oversized {0}; // Responses stopped at a stored message too large for one packet
+    uint64_t packets_sent {0};
+    uint64_t messages_sent {0};
+    uint64_t send_errors {0};
+};
+
+/*
+MoldUDP64 retransmission (request) server.
+A request reuses the packet header layout: session, first requested sequence number and
+requested message count. Responses are regular MoldUDP64 packets built from the store.
+The rate limit is per source IP, so a requester cannot refresh its budget by switching
+ports, and is charged once per coalesced range rather than once per duplicate request.
+
+Requests are read and answered in batches. Within a batch, overlapping requests from the
+same requester are merged and packets starting at the same sequence number are built once
+and sent to everyone who asked, so a burst of identical requests after a network blip costs
+little more than one.
+*/
+class MoldUDPRewinder {
+public:
+    MoldUDPRewinder(const MoldUDPMessageStore& store, MoldUDPRewinderConfig config);
+
+    // The batch headers point into the object itself
+    MoldUDPRewinder(const MoldUDPRewinder&) = delete;
+    MoldUDPRewinder& operator=(const MoldUDPRewinder&) = delete;
+
+    // Blocks until at least one request arrives, then answers the whole batch; returns early on a signal
+    void serve_once();
+
+    const MoldUDPRewinderStats& get_stats() const;
+
+private:
+    struct ClientState {
+        double tokens;
+        std::chrono::steady_clock::time_point last_seen;
+    };
+
+    struct PendingRange {
+        uint64_t client_key;
+        sockaddr_in client_addr;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct BuiltPacket {
+        std::vector<uint8_t> bytes;
+        uint64_t end; // One past the last sequence number in the packet
+        uint16_t message_count;
+    };
+
+    // Applies the source IP's token bucket and returns how many of count messages may be sent
+    uint64_t admit(uint32_t client_ip, uint64_t count, std::chrono::steady_clock::time_point now);
+    // Returns tokens for admitted messages that were not sent after all
+    void refund(uint32_t client_ip, uint64_t count);
+    // nullptr if the message at begin does not fit in a packet on its own
+    const BuiltPacket* packet_starting_at(uint64_t begin, uint64_t end);
+    void queue_send(const BuiltPacket& packet, const sockaddr_in& dest);
+    void flush_sends();
+    void evict_idle_clients(std::chrono::steady_clock::time_point now);
+
+    static constexpr size_t REQUEST_BATCH_SIZE = 64;
+    static constexpr size_t SEND_BATCH_SIZE = 64;
+
+    const MoldUDPMessageStore& m_store;
+    MoldUDPRewinderConfig m_config;
+    MoldUDPRewinderStats m_stats {};
+    UDPSocket m_socket;
+    MoldUDPPacketBuilder m_builder;
+    MoldUDP64PacketHeader m_session_header {};
+
+    // Request receive batch
+    std::array<std::array<uint8_t, 64>, REQUEST_BATCH_SIZE> m_request_buffers {};
+    std::array<iovec, REQUEST_BATCH_SIZE> m_request_iovecs {};
+    std::array<sockaddr_in, REQUEST_BATCH_SIZE> m_request_senders {};
+    std::array<mmsghdr, REQUEST_BATCH_SIZE> m_request_headers {};
+
+    // Response send batch; packets live in m_packets until the end of serve_once()
+    std::array<iovec, SEND_BATCH_SIZE> m_send_iovecs {};
+    std::array<sockaddr_in, SEND_BATCH_SIZE> m_send_dests {};
+    std::array<mmsghdr, SEND_BATCH_SIZE> m_send_headers {};
+    size_t m_send_count {0};
+
+    std::vector<PendingRange> m_pending;
+    std::deque<BuiltPacket> m_packets;
+    std::unordered_map<uint64_t, const BuiltPacket*> m_packets_by_begin;
+    std::unordered_map<uint32_t, ClientState> m_clients; // By source IP
+    std::chrono::steady_clock::time_point m_last_eviction;
+};
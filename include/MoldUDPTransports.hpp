@@ -0,0 +1,368 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+#ifdef MOLD_UDP_HAS_IO_URING
+#include <liburing.h>
+#endif
+
+#ifdef MOLD_UDP_HAS_PCAP
+#include <pcap/pcap.h>
+#endif
+
+#include <HotPathArena.hpp>
+#include <MoldUDPProtocol.hpp>
+#include <UDPSocket.hpp>
+
+/*
+Transport policies for MoldUDPReceiver.
+
+Every transport exposes poll(on_datagram, on_burst_end), which receives whatever is
+available (blocking where the transport blocks) and calls
+    on_datagram(const uint8_t* payload, size_t length, const sockaddr_in& sender)
+once per UDP payload, then on_burst_end() once the burst is done. Payload pointers stay
+valid until on_burst_end() returns, so a caller may index a whole burst before using it.
+
+Transports that subscribe to a multicast group also expose join(). Their constructors set
+everything up (socket, buffers, rings) but nothing arrives until join() is called, which
+lets the receiver warm its hot path first. Receive buffers come from the memory resource
+passed to the constructor, typically a HotPathArena.
+*/
+
+constexpr size_t RECEIVE_BATCH_SIZE = 32;
+
+// Default burst-end callback for callers that consume each datagram as it arrives
+struct NoBurstEnd {
+    void operator()() const {}
+};
+
+struct UDPDatagramView {
+    const uint8_t* payload;
+    size_t length;
+    sockaddr_in sender;
+};
+
+/*
+Extract the UDP payload from a raw Ethernet frame if it is addressed to dst_ip:dst_port.
+Both dst_ip and dst_port are in network byte order. Used by the transports that see whole
+frames (DPDK, pcap) rather than datagrams.
+*/
+[[gnu::always_inline]] inline bool extract_udp_datagram(const uint8_t* frame, size_t frame_len,
+    uint32_t dst_ip, uint16_t dst_port, UDPDatagramView& datagram) {
+
+    constexpr size_t ETHER_HEADER_LEN = 14;
+    constexpr size_t VLAN_TAG_LEN = 4;
+    constexpr size_t UDP_HEADER_LEN = 8;
+
+    if (frame_len < ETHER_HEADER_LEN) {
+        return false;
+    }
+
+    size_t offset = ETHER_HEADER_LEN;
+    uint16_t ether_type = static_cast<uint16_t>((frame[12] << 8) | frame[13]);
+
+    if (ether_type == 0x8100) { // 802.1Q tagged frame
+        if (frame_len < ETHER_HEADER_LEN + VLAN_TAG_LEN) {
+            return false;
+        }
+        ether_type = static_cast<uint16_t>((frame[16] << 8) | frame[17]);
+        offset += VLAN_TAG_LEN;
+    }
+
+    if (ether_type != 0x0800 || frame_len < offset + 20) {
+        return false;
+    }
+
+    const uint8_t* ip_hdr = frame + offset;
+    size_t ip_hdr_len = (ip_hdr[0] & 0x0F) * 4;
+
+    if (ip_hdr[9] != IPPROTO_UDP || ip_hdr_len < 20 || frame_len < offset + ip_hdr_len + UDP_HEADER_LEN) {
+        return false;
+    }
+
+    uint32_t ip_dst;
+    std::memcpy(&ip_dst, ip_hdr + 16, sizeof(ip_dst));
+
+    if (ip_dst != dst_ip) {
+        return false;
+    }
+
+    const uint8_t* udp_hdr = ip_hdr + ip_hdr_len;
+    uint16_t udp_dst_port;
+    uint16_t udp_len;
+    std::memcpy(&udp_dst_port, udp_hdr + 2, sizeof(udp_dst_port));
+    std::memcpy(&udp_len, udp_hdr + 4, sizeof(udp_len));
+    udp_len = ntohs(udp_len);
+
+    if (udp_dst_port != dst_port || udp_len < UDP_HEADER_LEN) {
+        return false;
+    }
+
+    size_t payload_offset = offset + ip_hdr_len + UDP_HEADER_LEN;
+    size_t payload_len = udp_len - UDP_HEADER_LEN;
+
+    if (payload_offset + payload_len > frame_len) {
+        return false; // Truncated frame (e.g. short pcap snaplen)
+    }
+
+    datagram.payload = frame + payload_offset;
+    datagram.length = payload_len;
+    datagram.sender = {};
+    datagram.sender.sin_family = AF_INET;
+    std::memcpy(&datagram.sender.sin_addr.s_addr, ip_hdr + 12, sizeof(uint32_t));
+    std::memcpy(&datagram.sender.sin_port, udp_hdr, sizeof(uint16_t));
+
+    return true;
+}
+
+// A socket bound to the group's port that only becomes a member of the group on join()
+class MulticastSocket {
+public:
+    MulticastSocket(const char* multicast_addr, int port, const char* interface_addr);
+
+    // Joins the group; further calls do nothing
+    void join();
+
+    UDPSocket& get_socket() { return m_socket; }
+    const std::string& get_multicast_address() const { return m_multicast_addr; }
+
+private:
+    UDPSocket m_socket;
+    std::string m_multicast_addr;
+    std::string m_interface_addr; // Empty for all interfaces
+    bool m_joined {false};
+};
+
+// One recvfrom per poll, the behaviour of the original receiver
+class SocketTransport {
+public:
+    SocketTransport(const char* multicast_addr, int port, const char* interface_addr = nullptr,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    template <typename OnDatagram, typename OnBurstEnd = NoBurstEnd>
+    [[gnu::always_inline]] void poll(OnDatagram&& on_datagram, OnBurstEnd&& on_burst_end = {}) {
+        sockaddr_in sender_addr {};
+
+        ssize_t received = m_socket.get_socket().receive_from(reinterpret_cast<char*>(m_buffer->data()),
+            m_buffer->size(), sender_addr);
+
+        if (received < 0) {
+            return; // Interrupted by a signal, let the caller check whether to stop
+        }
+
+        on_datagram(m_buffer->data(), static_cast<size_t>(received), sender_addr);
+        on_burst_end();
+    }
+
+    void join();
+
+    const std::string& get_multicast_address() const;
+
+private:
+    MulticastSocket m_socket;
+    MemoryResourcePtr<std::array<uint8_t, MAX_PACKET_SIZE>> m_buffer;
+};
+
+// Up to RECEIVE_BATCH_SIZE datagrams per system call via recvmmsg
+class RecvmmsgTransport {
+public:
+    RecvmmsgTransport(const char* multicast_addr, int port, const char* interface_addr = nullptr,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    template <typename OnDatagram, typename OnBurstEnd = NoBurstEnd>
+    [[gnu::always_inline]] void poll(OnDatagram&& on_datagram, OnBurstEnd&& on_burst_end = {}) {
+        Batch& batch = *m_batch;
+
+        int received = m_socket.get_socket().receive_many(batch.headers.data(), RECEIVE_BATCH_SIZE);
+
+        for (int i = 0; i < received; i++) {
+            on_datagram(batch.buffers[i].data(), batch.headers[i].msg_len, batch.senders[i]);
+            batch.headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in); // Value-result, reset for next call
+        }
+
+        on_burst_end();
+    }
+
+    void join();
+
+    const std::string& get_multicast_address() const;
+
+private:
+    // Allocated separately so the self-referencing mmsghdr/iovec pointers survive moves
+    struct Batch {
+        std::array<std::array<uint8_t, MAX_PACKET_SIZE>, RECEIVE_BATCH_SIZE> buffers {};
+        std::array<iovec, RECEIVE_BATCH_SIZE> iovecs {};
+        std::array<sockaddr_in, RECEIVE_BATCH_SIZE> senders {};
+        std::array<mmsghdr, RECEIVE_BATCH_SIZE> headers {};
+    };
+
+    MulticastSocket m_socket;
+    MemoryResourcePtr<Batch> m_batch;
+};
+
+#ifdef MOLD_UDP_HAS_IO_URING
+// Keeps RECEIVE_BATCH_SIZE recvmsg requests in flight on an io_uring, re-arming them after each burst
+class IoUringTransport {
+public:
+    IoUringTransport(const char* multicast_addr, int port, const char* interface_addr = nullptr,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+    ~IoUringTransport();
+
+    IoUringTransport(IoUringTransport&&) noexcept = default;
+    IoUringTransport& operator=(IoUringTransport&&) noexcept = default;
+
+    template <typename OnDatagram, typename OnBurstEnd = NoBurstEnd>
+    [[gnu::always_inline]] void poll(OnDatagram&& on_datagram, OnBurstEnd&& on_burst_end = {}) {
+        Ring& ring = *m_ring;
+        io_uring_cqe* cqe;
+
+        int waited = io_uring_wait_cqe(&ring.ring, &cqe);
+
+        if (waited == -EINTR) {
+            return; // Interrupted by a signal, let the caller check whether to stop
+        }
+
+        if (waited < 0) {
+            throw std::runtime_error("Failed to wait for io_uring completion");
+        }
+
+        unsigned head;
+        unsigned completed = 0;
+        std::array<size_t, RECEIVE_BATCH_SIZE> slots;
+
+        io_uring_for_each_cqe(&ring.ring, head, cqe) {
+            size_t slot = static_cast<size_t>(io_uring_cqe_get_data64(cqe));
+
+            if (cqe->res < 0) {
+                throw std::runtime_error("Failed to receive data");
+            }
+
+            on_datagram(ring.buffers[slot].data(), static_cast<size_t>(cqe->res), ring.senders[slot]);
+            slots[completed++] = slot;
+        }
+
+        io_uring_cq_advance(&ring.ring, completed);
+        on_burst_end();
+
+        // Only hand the buffers back to the kernel once the burst has been consumed
+        for (unsigned i = 0; i < completed; i++) {
+            arm(slots[i]);
+        }
+
+        io_uring_submit(&ring.ring);
+    }
+
+    void join();
+
+    const std::string& get_multicast_address() const;
+
+private:
+    struct Ring {
+        io_uring ring {};
+        std::array<std::array<uint8_t, MAX_PACKET_SIZE>, RECEIVE_BATCH_SIZE> buffers {};
+        std::array<iovec, RECEIVE_BATCH_SIZE> iovecs {};
+        std::array<sockaddr_in, RECEIVE_BATCH_SIZE> senders {};
+        std::array<msghdr, RECEIVE_BATCH_SIZE> headers {};
+    };
+
+    void arm(size_t slot) {
+        Ring& ring = *m_ring;
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring.ring);
+
+        ring.headers[slot].msg_namelen = sizeof(sockaddr_in);
+        io_uring_prep_recvmsg(sqe, m_socket.get_socket().get_socket_fd(), &ring.headers[slot], 0);
+        io_uring_sqe_set_data64(sqe, slot);
+    }
+
+    MulticastSocket m_socket;
+    MemoryResourcePtr<Ring> m_ring;
+};
+#endif
+
+#ifdef MOLD_UDP_HAS_PCAP
+// Reads frames from a capture file, or from a live device if source is not a readable capture file
+class PcapTransport {
+public:
+    PcapTransport(const char* source, const char* multicast_addr, int port);
+    ~PcapTransport();
+
+    PcapTransport(PcapTransport&& other) noexcept;
+    PcapTransport& operator=(PcapTransport&& other) noexcept;
+
+    template <typename OnDatagram, typename OnBurstEnd = NoBurstEnd>
+    [[gnu::always_inline]] void poll(OnDatagram&& on_datagram, OnBurstEnd&& on_burst_end = {}) {
+        for (size_t i = 0; i < RECEIVE_BATCH_SIZE; i++) {
+            pcap_pkthdr* pkt_header;
+            const u_char* frame;
+
+            int ret = pcap_next_ex(m_handle, &pkt_header, &frame);
+
+            if (ret == 0) {
+                break; // Live capture timeout
+            }
+
+            if (ret == PCAP_ERROR_BREAK) {
+                m_exhausted = true;
+                break;
+            }
+
+            if (ret < 0) {
+                throw std::runtime_error("Failed to read from capture");
+            }
+
+            UDPDatagramView datagram;
+
+            if (extract_udp_datagram(frame, pkt_header->caplen, m_multicast_ip, m_port, datagram)) {
+                on_datagram(datagram.payload, datagram.length, datagram.sender);
+                on_burst_end(); // libpcap reuses the frame buffer on the next read
+            }
+        }
+    }
+
+    // True once an offline capture has been read to the end
+    bool is_exhausted() const;
+
+    const std::string& get_multicast_address() const;
+
+private:
+    pcap_t* m_handle;
+    std::string m_multicast_addr;
+    uint32_t m_multicast_ip; // Network byte order
+    uint16_t m_port; // Network byte order
+    bool m_exhausted {false};
+};
+#endif
+
+// Replays a fixed set of in-memory packets, RECEIVE_BATCH_SIZE per poll and wrapping around, for benchmarks and local testing
+class ReplayTransport {
+public:
+    explicit ReplayTransport(std::vector<std::vector<uint8_t>> packets);
+
+    template <typename OnDatagram, typename OnBurstEnd = NoBurstEnd>
+    [[gnu::always_inline]] void poll(OnDatagram&& on_datagram, OnBurstEnd&& on_burst_end = {}) {
+        for (size_t i = 0; i < RECEIVE_BATCH_SIZE && !m_packets.empty(); i++) {
+            const std::vector<uint8_t>& packet = m_packets[m_next];
+            on_datagram(packet.data(), packet.size(), m_sender);
+            m_next = m_next + 1 == m_packets.size() ? 0 : m_next + 1;
+        }
+
+        on_burst_end();
+    }
+
+    const std::string& get_multicast_address() const;
+
+private:
+    std::vector<std::vector<uint8_t>> m_packets;
+    size_t m_next {0};
+    std::string m_multicast_addr {"replay"};
+    sockaddr_in m_sender {};
+};
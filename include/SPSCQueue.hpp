@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Spin-wait hint for busy polling loops
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+/*
+Bounded lock-free single-producer/single-consumer ring.
+
+Slots are filled and drained in place. Both sides batch their index updates: the producer
+claims and commits any number of slots and only makes them visible with publish(), and the
+consumer pops several slots before handing them back with release(). Each side keeps a
+cached copy of the other side's index so the shared cache line is only touched when the
+cached view says the ring is full (producer) or empty (consumer).
+*/
+template <typename T>
+class SPSCQueue {
+public:
+    explicit SPSCQueue(size_t capacity)
+        : m_capacity(std::bit_ceil(capacity < 2 ? size_t(2) : capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(std::make_unique<T[]>(m_capacity)) {}
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer: next free slot, or nullptr if the ring is full
+    T* try_claim() {
+        if (m_producer.tail - m_producer.cached_head == m_capacity) {
+            m_producer.cached_head = m_head.value.load(std::memory_order_acquire);
+
+            if (m_producer.tail - m_producer.cached_head == m_capacity) {
+                return nullptr;
+            }
+        }
+
+        return &m_slots[m_producer.tail & m_mask];
+    }
+
+    // Producer: the slot returned by try_claim() is filled
+    void commit() { m_producer.tail++; }
+
+    // Producer: make every committed slot visible to the consumer
+    void publish() { m_tail.value.store(m_producer.tail, std::memory_order_release); }
+
+    // Producer: position one past the last committed slot
+    uint64_t get_producer_position() const { return m_producer.tail; }
+
+    // Consumer: oldest published slot, or nullptr if there is none
+    T* front() {
+        if (m_consumer.head == m_consumer.cached_tail) {
+            m_consumer.cached_tail = m_tail.value.load(std::memory_order_acquire);
+
+            if (m_consumer.head == m_consumer.cached_tail) {
+                return nullptr;
+            }
+        }
+
+        return &m_slots[m_consumer.head & m_mask];
+    }
+
+    // Consumer: done with the slot returned by front()
+    void pop() { m_consumer.head++; }
+
+    // Consumer: hand every popped slot back to the producer
+    void release() { m_head.value.store(m_consumer.head, std::memory_order_release); }
+
+    // Any thread: slots the consumer has released so far
+    uint64_t get_consumer_position() const { return m_head.value.load(std::memory_order_acquire); }
+
+    // Any thread: published slots not yet released, may be stale by the time it returns
+    size_t get_size_approx() const {
+        return static_cast<size_t>(m_tail.value.load(std::memory_order_relaxed)
+            - m_head.value.load(std::memory_order_relaxed));
+    }
+
+    size_t get_capacity() const { return m_capacity; }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    struct alignas(CACHE_LINE_SIZE) SharedIndex {
+        std::atomic<uint64_t> value {0};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ProducerState {
+        uint64_t tail {0};
+        uint64_t cached_head {0};
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ConsumerState {
+        uint64_t head {0};
+        uint64_t cached_tail {0};
+    };
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    SharedIndex m_head;
+    SharedIndex m_tail;
+    ProducerState m_producer;
+    ConsumerState m_consumer;
+};
@@ -0,0 +1,461 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <MoldUDPMessageBatch.hpp>
+#include <MoldUDPParser.hpp>
+#include <SPSCQueue.hpp>
+
+struct ShardedDispatcherConfig {
+    size_t worker_count {1};
+    size_t queue_capacity {1 << 16}; // Messages per worker queue, rounded up to a power of two
+    std::vector<int> worker_cpus; // Core for worker i, or -1 / missing to leave it unpinned
+    uint32_t key_space {1u << 16}; // Keys at or above this (and NO_MESSAGE_KEY) all go to worker 0
+    uint64_t rebalance_interval {1 << 20}; // Messages between load checks, 0 disables rebalancing
+    double rebalance_threshold {1.5}; // Rebalance when the busiest worker exceeds this times the mean
+};
+
+struct ShardedDispatcherWorkerMetrics {
+    size_t queue_depth;
+    uint64_t processed;
+    uint64_t last_lag_ns; // Enqueue to dequeue time of the most recently drained message
+    uint64_t max_lag_ns;
+    uint64_t producer_stalls; // Times the receive thread found this worker's queue full
+};
+
+// Pins a thread to one core; returns false (and leaves it unpinned) on failure
+bool pin_thread_to_cpu(std::thread& thread, int cpu);
+
+/*
+Fans messages out from the receive thread to N worker threads by instrument key.
+
+Every key is routed to exactly one worker at a time and each worker has its own SPSC
+queue, so messages for one instrument are handled in order. Messages are copied into
+fixed-size queue slots (MaxMessageSize bytes; longer messages are dropped and counted).
+
+Hot instruments are rebalanced on the receive thread: every rebalance_interval messages,
+if the busiest worker is over the threshold, the one key whose move best evens out the
+busiest and idlest workers is moved. If the old owner still has messages queued for that
+key, a fence is queued ahead of the new owner's first message for it, so the new owner
+waits until the old one is done: per-instrument order holds across moves, and handlers may
+keep per-instrument state shared between workers without locking it.
+*/
+template <MoldUDPHandler Handler, size_t MaxMessageSize = 64>
+class ShardedDispatcher {
+public:
+    using HandlerFactory = std::function<Handler(size_t worker)>;
+
+    ShardedDispatcher(ShardedDispatcherConfig config, HandlerFactory make_handler)
+        : m_config(std::move(config))
+        , m_routes(static_cast<size_t>(m_config.key_space) + 1)
+        , m_last_position(m_routes.size(), 0)
+        , m_key_counts(m_routes.size(), 0)
+        , m_window_load(m_config.worker_count, 0)
+        , m_dirty(m_config.worker_count, false) {
+
+        if (m_config.worker_count == 0 || m_config.worker_count > UINT16_MAX) {
+            throw std::invalid_argument("Dispatcher needs between 1 and 65535 workers");
+        }
+
+        for (size_t key = 0; key < m_routes.size(); key++) {
+            m_routes[key] = static_cast<uint16_t>(key == m_config.key_space ? 0 : key % m_config.worker_count);
+        }
+
+        m_dirty_workers.reserve(m_config.worker_count);
+
+        try {
+            for (size_t i = 0; i < m_config.worker_count; i++) {
+                m_workers.push_back(std::make_unique<Worker>(m_config.queue_capacity, make_handler(i)));
+            }
+
+            for (size_t i = 0; i < m_config.worker_count; i++) {
+                m_workers[i]->thread = std::thread([this, i] { run_worker(i); });
+
+                if (i < m_config.worker_cpus.size() && m_config.worker_cpus[i] >= 0) {
+                    pin_thread_to_cpu(m_workers[i]->thread, m_config.worker_cpus[i]);
+                }
+            }
+        } catch (...) {
+            // The destructor won't run: join the workers already started, or destroying them terminates
+            stop();
+            throw;
+        }
+    }
+
+    ~ShardedDispatcher() {
+        stop();
+    }
+
+    ShardedDispatcher(const ShardedDispatcher&) = delete;
+    ShardedDispatcher& operator=(const ShardedDispatcher&) = delete;
+
+    // Receive thread: stamp subsequent messages with the current time for lag tracking
+    void begin_burst() {
+        m_burst_time_ns = now_ns();
+    }
+
+    // Receive thread: queue one message; it becomes visible to its worker on publish()
+    [[gnu::always_inline]] void dispatch(uint64_t sequence, uint32_t key, std::string_view message) {
+        if (message.size() > MaxMessageSize) {
+            m_oversized++;
+            return;
+        }
+
+        uint32_t route_key = key < m_config.key_space ? key : m_config.key_space;
+        uint16_t worker_index = m_routes[route_key];
+        Worker& worker = *m_workers[worker_index];
+        Slot* slot = claim_slot(worker);
+
+        slot->sequence = sequence;
+        slot->enqueue_ns = m_burst_time_ns;
+        slot->fence_worker = NO_FENCE;
+        slot->length = static_cast<uint16_t>(message.size());
+        std::memcpy(slot->data, message.data(), message.size());
+        worker.queue.commit();
+        mark_dirty(worker_index);
+
+        m_last_position[route_key] = worker.queue.get_producer_position();
+        m_key_counts[route_key]++;
+        m_window_load[worker_index]++;
+
+        if (m_config.rebalance_interval != 0 && ++m_window_messages == m_config.rebalance_interval) {
+            rebalance();
+        }
+    }
+
+    // Receive thread: make every queued message visible to the workers
+    void publish() {
+        // Only queues written since the last publish, so idle workers' tail lines stay untouched
+        for (uint16_t index : m_dirty_workers) {
+            m_workers[index]->queue.publish();
+            m_dirty[index] = false;
+        }
+
+        m_dirty_workers.clear();
+    }
+
+    // Drains every queue and joins the workers; further dispatch() calls are not allowed
+    void stop() {
+        if (!m_running.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // Publish before clearing the flag so a worker that sees it stopped also sees every message
+        publish();
+        m_running.store(false, std::memory_order_release);
+
+        for (std::unique_ptr<Worker>& worker : m_workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    // Receive thread only: blocks until workers have handled every published message
+    void wait_until_drained() const {
+        for (const std::unique_ptr<Worker>& worker : m_workers) {
+            while (worker->queue.get_consumer_position() < worker->queue.get_producer_position()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    size_t get_worker_count() const { return m_workers.size(); }
+    uint64_t get_oversized_count() const { return m_oversized; }
+    uint64_t get_migration_count() const { return m_migrations; }
+
+    // Which worker currently owns a key (receive thread only)
+    size_t get_route(uint32_t key) const {
+        return m_routes[key < m_config.key_space ? key : m_config.key_space];
+    }
+
+    ShardedDispatcherWorkerMetrics get_worker_metrics(size_t index) const {
+        const Worker& worker = *m_workers[index];
+
+        return {
+            worker.queue.get_size_approx(),
+            worker.processed.load(std::memory_order_relaxed),
+            worker.last_lag_ns.load(std::memory_order_relaxed),
+            worker.max_lag_ns.load(std::memory_order_relaxed),
+            worker.producer_stalls.load(std::memory_order_relaxed),
+        };
+    }
+
+    // Only safe to call once stop() has returned
+    Handler& get_worker_handler(size_t index) { return m_workers[index]->handler; }
+
+private:
+    static constexpr uint16_t NO_FENCE = UINT16_MAX;
+
+    /*
+    Either a message, or a fence (fence_worker != NO_FENCE) telling the worker to wait until
+    worker fence_worker has released everything up to fence_position before going on.
+    */
+    struct Slot {
+        uint64_t sequence;
+        uint64_t enqueue_ns;
+        uint64_t fence_position;
+        uint16_t fence_worker;
+        uint16_t length;
+        char data[MaxMessageSize];
+    };
+
+    struct Worker {
+        Worker(size_t capacity, Handler worker_handler)
+            : queue(capacity)
+            , handler(std::move(worker_handler)) {}
+
+        SPSCQueue<Slot> queue;
+        Handler handler;
+        std::thread thread;
+
+        // Written by the worker, read by anyone
+        alignas(64) std::atomic<uint64_t> processed {0};
+        std::atomic<uint64_t> last_lag_ns {0};
+        std::atomic<uint64_t> max_lag_ns {0};
+
+        // Written by the receive thread
+        alignas(64) std::atomic<uint64_t> producer_stalls {0};
+    };
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void mark_dirty(uint16_t worker_index) {
+        if (!m_dirty[worker_index]) {
+            m_dirty[worker_index] = true;
+            m_dirty_workers.push_back(worker_index);
+        }
+    }
+
+    Slot* claim_slot(Worker& worker) {
+        Slot* slot = worker.queue.try_claim();
+
+        while (slot == nullptr) {
+            // Lossless back-pressure: make what we have visible and wait for the worker
+            worker.producer_stalls.store(worker.producer_stalls.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+            worker.queue.publish();
+            cpu_relax();
+            slot = worker.queue.try_claim();
+        }
+
+        return slot;
+    }
+
+    void wait_for_fence(const Slot& fence) {
+        const SPSCQueue<Slot>& previous_owner = m_workers[fence.fence_worker]->queue;
+
+        while (previous_owner.get_consumer_position() < fence.fence_position) {
+            cpu_relax();
+            std::this_thread::yield();
+        }
+    }
+
+    void run_worker(size_t index) {
+        constexpr size_t DRAIN_BATCH = 256;
+        constexpr unsigned SPINS_BEFORE_YIELD = 1024;
+
+        Worker& worker = *m_workers[index];
+        unsigned idle_spins = 0;
+
+        while (true) {
+            Slot* slot = worker.queue.front();
+
+            if (slot == nullptr) {
+                if (!m_running.load(std::memory_order_acquire)) {
+                    if (worker.queue.front() == nullptr) {
+                        break; // Stopped and fully drained
+                    }
+                    continue;
+                }
+
+                if (++idle_spins < SPINS_BEFORE_YIELD) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+
+            idle_spins = 0;
+
+            // One clock read per drained batch, measured against its oldest message
+            uint64_t lag = now_ns() - slot->enqueue_ns;
+            size_t drained = 0;
+
+            do {
+                if (slot->fence_worker != NO_FENCE) {
+                    // Hand back what we have first: fences only point backwards in time, so
+                    // as long as every waiting worker has released, no wait can be circular
+                    worker.queue.release();
+                    wait_for_fence(*slot);
+                } else {
+                    worker.handler.on_message(slot->sequence, std::string_view(slot->data, slot->length));
+                    drained++;
+                }
+                worker.queue.pop();
+            } while (drained < DRAIN_BATCH && (slot = worker.queue.front()) != nullptr);
+
+            worker.queue.release();
+
+            worker.processed.store(worker.processed.load(std::memory_order_relaxed) + drained,
+                std::memory_order_relaxed);
+            worker.last_lag_ns.store(lag, std::memory_order_relaxed);
+
+            if (lag > worker.max_lag_ns.load(std::memory_order_relaxed)) {
+                worker.max_lag_ns.store(lag, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void rebalance() {
+        size_t worker_count = m_workers.size();
+        auto [coldest, hottest] = std::minmax_element(m_window_load.begin(), m_window_load.end());
+        size_t hot = static_cast<size_t>(hottest - m_window_load.begin());
+        size_t cold = static_cast<size_t>(coldest - m_window_load.begin());
+        double mean = static_cast<double>(m_window_messages) / static_cast<double>(worker_count);
+
+        if (worker_count > 1 && static_cast<double>(*hottest) > mean * m_config.rebalance_threshold) {
+            // Key on the hot worker whose move leaves the larger of the two loads smallest
+            size_t best_key = m_routes.size();
+            uint64_t best_peak = *hottest;
+
+            for (size_t key = 0; key < m_config.key_space; key++) {
+                uint64_t count = m_key_counts[key];
+
+                if (count == 0 || m_routes[key] != hot) {
+                    continue;
+                }
+
+                uint64_t peak = std::max(*hottest - count, *coldest + count);
+
+                if (peak < best_peak) {
+                    best_key = key;
+                    best_peak = peak;
+                }
+            }
+
+            if (best_key != m_routes.size()) {
+                migrate(best_key, hot, cold);
+            }
+        }
+
+        std::fill(m_key_counts.begin(), m_key_counts.end(), 0);
+        std::fill(m_window_load.begin(), m_window_load.end(), 0);
+        m_window_messages = 0;
+    }
+
+    void migrate(size_t key, size_t from, size_t to) {
+        Worker& target = *m_workers[to];
+
+        // The new owner must not start on this key until the old one has finished with it
+        if (m_workers[from]->queue.get_consumer_position() < m_last_position[key]) {
+            // Publish what the fence waits on, or a stall on the new owner could never clear
+            m_workers[from]->queue.publish();
+
+            Slot* fence = claim_slot(target);
+            fence->enqueue_ns = m_burst_time_ns;
+            fence->fence_worker = static_cast<uint16_t>(from);
+            fence->fence_position = m_last_position[key];
+            target.queue.commit();
+            mark_dirty(static_cast<uint16_t>(to));
+        }
+
+        m_routes[key] = static_cast<uint16_t>(to);
+        m_last_position[key] = target.queue.get_producer_position();
+        m_migrations++;
+    }
+
+    ShardedDispatcherConfig m_config;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_running {true};
+
+    // Receive thread state
+    std::vector<uint16_t> m_routes; // Worker per key, plus one shared entry for unkeyed messages
+    std::vector<uint64_t> m_last_position; // Producer position after the key's latest message
+    std::vector<uint32_t> m_key_counts; // Messages per key in the current window
+    std::vector<uint64_t> m_window_load; // Messages per worker in the current window
+    uint64_t m_window_messages {0};
+    std::vector<bool> m_dirty; // Worker has committed slots not yet published
+    std::vector<uint16_t> m_dirty_workers;
+    uint64_t m_burst_time_ns {0};
+    uint64_t m_oversized {0};
+    uint64_t m_migrations {0};
+};
+
+// Per-message MoldUDPReceiver handler feeding a ShardedDispatcher
+template <typename Dispatcher>
+class DispatchingHandler {
+public:
+    explicit DispatchingHandler(Dispatcher& dispatcher, MessageKeyField key_field = ITCH_STOCK_LOCATE)
+        : m_dispatcher(&dispatcher)
+        , m_key_field(key_field) {}
+
+    void on_datagram(const sockaddr_in&, size_t) {}
+    void on_packet(const MoldUDP64PacketHeader&) { m_dispatcher->begin_burst(); }
+    void on_error(const char*) {}
+
+    void on_message(uint64_t sequence, std::string_view message) {
+        uint32_t key = read_message_key(reinterpret_cast<const uint8_t*>(message.data()), message.size(), m_key_field);
+
+        if (!m_warming_up) [[likely]] {
+            m_dispatcher->dispatch(sequence, key, message);
+            m_dispatcher->publish(); // Only the queue this message went to
+        }
+    }
+
+    // Synthetic warm-up messages are keyed but never reach the workers
+    void on_warm_up(bool active) { m_warming_up = active; }
+
+private:
+    Dispatcher* m_dispatcher;
+    MessageKeyField m_key_field;
+    bool m_warming_up {false};
+};
+
+// Batch MoldUDPReceiver handler feeding a ShardedDispatcher from the key column, one publish per burst
+template <typename Dispatcher>
+class DispatchingBatchHandler {
+public:
+    explicit DispatchingBatchHandler(Dispatcher& dispatcher)
+        : m_dispatcher(&dispatcher) {}
+
+    void on_batch(const MoldUDPMessageBatch& batch) {
+        if (m_warming_up) [[unlikely]] {
+            return;
+        }
+
+        auto sequences = batch.get_sequence_numbers();
+        auto keys = batch.get_keys();
+
+        m_dispatcher->begin_burst();
+
+        for (size_t i = 0; i < batch.size(); i++) {
+            m_dispatcher->dispatch(sequences[i], keys[i], batch.get_message(i));
+        }
+
+        m_dispatcher->publish();
+    }
+
+    void on_error(const char*) {}
+    void on_warm_up(bool active) { m_warming_up = active; }
+
+private:
+    Dispatcher* m_dispatcher;
+    bool m_warming_up {false};
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <MoldUDPMessageBatch.hpp>
+#include <MoldUDPParser.hpp>
+
+/*
+Set of subscribed instrument keys (e.g. ITCH stock locates) stored as a bitmap.
+A 16-bit key space takes 8 KiB, which stays resident in L1 while a burst is filtered.
+
+subscribe()/unsubscribe() may be called from any thread while the receive thread is
+filtering: each bit lives in an atomic word, so updates never take a lock and a reader
+sees either the old or the new state of each key.
+*/
+class SubscriptionFilter {
+public:
+    explicit SubscriptionFilter(uint32_t key_space = 1u << 16);
+
+    void subscribe(uint32_t key);
+    void unsubscribe(uint32_t key);
+    void subscribe_all();
+    void clear();
+
+    // Keys outside the key space (including NO_MESSAGE_KEY) are never subscribed
+    bool contains(uint32_t key) const {
+        key = key < m_key_space ? key : m_key_space; // The sentinel bit at m_key_space is always clear
+        return (m_words[key >> 6].load(std::memory_order_relaxed) >> (key & 63)) & 1;
+    }
+
+    uint32_t get_key_space() const { return m_key_space; }
+    size_t get_subscription_count() const;
+
+    // Raw view of the bitmap for the vectorised kernels; the sentinel word is included
+    const std::atomic<uint64_t>* get_words() const { return m_words.get(); }
+
+private:
+    uint32_t m_key_space;
+    size_t m_word_count;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+};
+
+/*
+Write the rows of batch whose key is subscribed to selection (room for batch.size() entries)
+and return how many there are. Uses AVX2 gathers when the CPU has them (checked at run time).
+*/
+size_t select_subscribed(const MoldUDPMessageBatch& batch, const SubscriptionFilter& filter, uint32_t* selection);
+
+// Per-message handler adapter that only forwards messages whose key is subscribed
+template <MoldUDPHandler Inner>
+class SubscribedHandler {
+public:
+    SubscribedHandler(const SubscriptionFilter& filter, Inner inner = {}, MessageKeyField key_field = ITCH_STOCK_LOCATE)
+        : m_filter(&filter)
+        , m_inner(std::move(inner))
+        , m_key_field(key_field) {}
+
+    void on_datagram(const sockaddr_in& sender, size_t length) { m_inner.on_datagram(sender, length); }
+    void on_packet(const MoldUDP64PacketHeader& header) { m_inner.on_packet(header); }
+    void on_error(const char* what) { m_inner.on_error(what); }
+    void on_warm_up(bool active) requires MoldUDPWarmUpHandler<Inner> { m_inner.on_warm_up(active); }
+
+    void on_message(uint64_t sequence, std::string_view message) {
+        uint32_t key = read_message_key(reinterpret_cast<const uint8_t*>(message.data()), message.size(), m_key_field);
+
+        if (m_filter->contains(key)) {
+            m_inner.on_message(sequence, message);
+        }
+    }
+
+    Inner& get_inner() { return m_inner; }
+
+private:
+    const SubscriptionFilter* m_filter;
+    Inner m_inner;
+    MessageKeyField m_key_field;
+};
+
+/*
+Batch handler adapter: filters each indexed burst with select_subscribed() and only then
+calls the per-message handler for the survivors. The key field is the batch's.
+*/
+template <MoldUDPHandler Inner>
+class SubscribedBatchHandler {
+public:
+    explicit SubscribedBatchHandler(const SubscriptionFilter& filter, Inner inner = {})
+        : m_filter(&filter)
+        , m_inner(std::move(inner)) {}
+
+    void on_batch(const MoldUDPMessageBatch& batch) {
+        if (m_selection.size() < batch.size()) {
+            m_selection.resize(batch.size());
+        }
+
+        size_t selected = select_subscribed(batch, *m_filter, m_selection.data());
+        auto sequences = batch.get_sequence_numbers();
+
+        for (size_t i = 0; i < selected; i++) {
+            uint32_t row = m_selection[i];
+            m_inner.on_message(sequences[row], batch.get_message(row));
+        }
+    }
+
+    void on_error(const char* what) { m_inner.on_error(what); }
+    void on_warm_up(bool active) requires MoldUDPWarmUpHandler<Inner> { m_inner.on_warm_up(active); }
+
+    Inner& get_inner() { return m_inner; }
+
+private:
+    const SubscriptionFilter* m_filter;
+    Inner m_inner;
+    std::vector<uint32_t> m_selection;
+};
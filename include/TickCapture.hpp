@@ -0,0 +1,341 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <netinet/in.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <MoldUDPMessageBatch.hpp>
+#include <MoldUDPParser.hpp>
+#include <SPSCQueue.hpp>
+
+/*
+Columnar tick capture.
+
+Decoded messages are stored per message type as columns: the MoldUDP64 sequence number
+followed by the fields the schema lists for that type (for ITCH: stock locate, tracking
+number, timestamp and the type's own fields). Rows are cut into chunks of up to
+chunk_rows; every column of a chunk is stored contiguously and 8-byte aligned, so a reader
+touches only the bytes of the columns it scans.
+
+File layout (native little-endian):
+    "TICKCAP1"
+    then, once per flush:
+        column chunks
+        footer: offset and size of the previous footer (0 for the first), the schema (first
+                footer only; per type: columns with name and type), then one entry per chunk
+                of this flush (type, column, codec, row count, offset, size, min, max)
+        footer offset (u64), footer size (u64), "TICKCAP1"
+
+A flush only appends, and its chunks and footer are synced before the trailer that points
+at them is written. A capture whose process is killed at any point, mid-flush included,
+is readable up to its last complete flush: the reader starts from the last complete
+trailer and follows the footers back.
+*/
+
+constexpr size_t MAX_TICK_MESSAGE_SIZE = 64; // Covers every ITCH 5.0 message the default schema captures
+
+enum class TickColumnType : uint8_t {
+    UINT8,
+    UINT16,
+    UINT32,
+    UINT64,
+    CHAR8, // 8 raw bytes, e.g. an ITCH stock symbol
+};
+
+enum class TickColumnCodec : uint8_t {
+    RAW, // Values at the column's width, directly usable from the mapping
+    DELTA_VARINT, // Zigzag-encoded deltas from the previous value as LEB128 varints
+};
+
+// A big-endian message field 1 to 8 bytes wide and the column type it is stored as
+struct TickFieldSpec {
+    std::string name;
+    uint16_t offset;
+    uint8_t width;
+    TickColumnType type;
+};
+
+// Which fields are captured for each message type; types without an entry are skipped
+class TickCaptureSchema {
+public:
+    void add_message_type(uint8_t type, std::vector<TickFieldSpec> fields);
+
+    // nullptr for types that are not captured
+    const std::vector<TickFieldSpec>* get_fields(uint8_t type) const {
+        return m_fields[type].empty() ? nullptr : &m_fields[type];
+    }
+
+    // System event, add order (with and without MPID), executions, cancel, delete, replace and trade
+    static TickCaptureSchema itch50();
+
+private:
+    std::array<std::vector<TickFieldSpec>, 256> m_fields;
+};
+
+// Append-only file written through a shared mapping that grows with it
+class MappedFileWriter {
+public:
+    explicit MappedFileWriter(const char* path);
+    ~MappedFileWriter();
+
+    MappedFileWriter(const MappedFileWriter&) = delete;
+    MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+    // Writes at offset, growing the file if needed
+    void write_at(size_t offset, const void* data, size_t size);
+
+    // Flushes the mapped range to disk before returning
+    void sync(size_t offset, size_t size);
+
+    void close();
+
+private:
+    void reserve(size_t size);
+
+    int m_fd;
+    uint8_t* m_mapped {nullptr};
+    size_t m_mapped_size {0};
+    size_t m_size {0};
+};
+
+struct TickCaptureConfig {
+    std::string path;
+    size_t queue_capacity {1 << 16}; // Messages between the receive and writer threads
+    size_t chunk_rows {1 << 16};
+    std::chrono::milliseconds flush_interval {1000}; // Partial chunks are written after this long
+    TickCaptureSchema schema {TickCaptureSchema::itch50()};
+};
+
+struct TickCaptureStats {
+    uint64_t captured;
+    uint64_t dropped; // Queue full, the receive thread never waits for the writer
+    uint64_t oversized; // Longer than MAX_TICK_MESSAGE_SIZE
+    uint64_t uncaptured; // No schema entry for the type, or shorter than its fields
+    uint64_t chunks_written;
+    uint64_t raw_bytes; // Column bytes before encoding
+    uint64_t file_bytes;
+};
+
+/*
+Receives messages on the receive thread and writes them out as column chunks on its own
+thread. The only work on the receive thread is one copy into a bounded SPSC queue, and
+a full queue drops the message rather than stalling the feed. Memory is bounded by the
+queue plus one chunk of rows per captured message type.
+*/
+class TickCaptureWriter {
+public:
+    explicit TickCaptureWriter(TickCaptureConfig config);
+    ~TickCaptureWriter();
+
+    TickCaptureWriter(const TickCaptureWriter&) = delete;
+    TickCaptureWriter& operator=(const TickCaptureWriter&) = delete;
+
+    // Receive thread: queue one message; it reaches the writer on publish()
+    [[gnu::always_inline]] bool submit(uint64_t sequence, std::string_view message) {
+        if (message.size() > MAX_TICK_MESSAGE_SIZE) [[unlikely]] {
+            m_oversized.store(m_oversized.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Slot* slot = m_queue.try_claim();
+
+        if (slot == nullptr) [[unlikely]] {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slot->sequence = sequence;
+        slot->length = static_cast<uint8_t>(message.size());
+        std::memcpy(slot->data, message.data(), message.size());
+        m_queue.commit();
+        return true;
+    }
+
+    // Receive thread
+    void publish() { m_queue.publish(); }
+
+    // Writes everything queued so far plus the footer and closes the file; rethrows writer errors
+    void close();
+
+    TickCaptureStats get_stats() const;
+
+private:
+    struct Slot {
+        uint64_t sequence;
+        uint8_t length;
+        char data[MAX_TICK_MESSAGE_SIZE];
+    };
+
+    struct ChunkEntry {
+        uint8_t message_type;
+        uint8_t column;
+        TickColumnCodec codec;
+        uint32_t row_count;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t min;
+        uint64_t max;
+    };
+
+    // Rows of one message type not yet written; column 0 is the sequence number
+    struct TypeBuffer {
+        const std::vector<TickFieldSpec>* fields {nullptr};
+        std::vector<std::vector<uint64_t>> values; // One per integer column
+        std::vector<std::vector<uint8_t>> bytes; // One per CHAR8 column
+        size_t min_length {0}; // Shorter messages do not hold every field
+        size_t rows {0};
+    };
+
+    void run();
+    void append_row(uint64_t sequence, const uint8_t* message, size_t length);
+    void flush_type(uint8_t type);
+    void flush_all();
+    void write_column(uint8_t type, uint8_t column, TickColumnType column_type, const std::vector<uint64_t>& values);
+    void write_chunk(const ChunkEntry& entry, const uint8_t* data);
+    void write_footer();
+
+    TickCaptureConfig m_config;
+    SPSCQueue<Slot> m_queue;
+    MappedFileWriter m_file;
+    std::array<TypeBuffer, 256> m_buffers;
+    std::vector<ChunkEntry> m_chunks; // Written since the last footer
+    std::vector<uint8_t> m_scratch; // Encoded column or footer being written
+    size_t m_data_end {0}; // Where the next chunk goes; the footer follows it
+    size_t m_synced_end {0}; // End of the last trailer; everything before it is on disk
+    uint64_t m_footer_offset {0}; // Of the last footer written, 0 before the first
+    uint64_t m_footer_size {0};
+
+    std::atomic<bool> m_running {true};
+    std::atomic<uint64_t> m_oversized {0};
+    std::atomic<uint64_t> m_dropped {0};
+    std::atomic<uint64_t> m_captured {0};
+    std::atomic<uint64_t> m_uncaptured {0};
+    std::atomic<uint64_t> m_chunks_written {0};
+    std::atomic<uint64_t> m_raw_bytes {0};
+    std::atomic<uint64_t> m_file_bytes {0};
+    std::exception_ptr m_error;
+    std::thread m_thread;
+};
+
+// Per-message MoldUDPReceiver handler feeding a TickCaptureWriter
+class TickCaptureHandler {
+public:
+    explicit TickCaptureHandler(TickCaptureWriter& writer)
+        : m_writer(&writer) {}
+
+    void on_datagram(const sockaddr_in&, size_t) {}
+    void on_packet(const MoldUDP64PacketHeader&) {}
+    void on_error(const char*) {}
+
+    void on_message(uint64_t sequence, std::string_view message) {
+        if (!m_warming_up) [[likely]] {
+            m_writer->submit(sequence, message);
+            m_writer->publish();
+        }
+    }
+
+    // Synthetic warm-up messages must not end up in the capture
+    void on_warm_up(bool active) { m_warming_up = active; }
+
+private:
+    TickCaptureWriter* m_writer;
+    bool m_warming_up {false};
+};
+
+// Batch MoldUDPReceiver handler feeding a TickCaptureWriter, one publish per burst
+class TickCaptureBatchHandler {
+public:
+    explicit TickCaptureBatchHandler(TickCaptureWriter& writer)
+        : m_writer(&writer) {}
+
+    void on_batch(const MoldUDPMessageBatch& batch) {
+        if (m_warming_up) [[unlikely]] {
+            return;
+        }
+
+        auto sequences = batch.get_sequence_numbers();
+
+        for (size_t i = 0; i < batch.size(); i++) {
+            m_writer->submit(sequences[i], batch.get_message(i));
+        }
+
+        m_writer->publish();
+    }
+
+    void on_error(const char*) {}
+    void on_warm_up(bool active) { m_warming_up = active; }
+
+private:
+    TickCaptureWriter* m_writer;
+    bool m_warming_up {false};
+};
+
+struct TickColumnInfo {
+    std::string name;
+    TickColumnType type;
+};
+
+// One column of one chunk, pointing into the reader's mapping
+struct TickColumnChunk {
+    TickColumnType type;
+    TickColumnCodec codec;
+    uint32_t row_count;
+    const uint8_t* data;
+    size_t size;
+    uint64_t min; // Of the integer values; 0 for CHAR8 columns
+    uint64_t max;
+};
+
+/*
+Memory-maps a capture file and gives access to single columns. Only the footers are parsed
+up front; column data is read from the mapping when a chunk is decoded, and RAW chunks
+need no decoding at all.
+*/
+class TickCaptureReader {
+public:
+    explicit TickCaptureReader(const char* path);
+    ~TickCaptureReader();
+
+    TickCaptureReader(const TickCaptureReader&) = delete;
+    TickCaptureReader& operator=(const TickCaptureReader&) = delete;
+
+    // Message types with at least one chunk
+    std::vector<uint8_t> get_message_types() const;
+
+    // Empty for types not in the file
+    const std::vector<TickColumnInfo>& get_columns(uint8_t type) const { return m_columns[type]; }
+
+    // Chunks of one column in write order, empty if the type or column is not in the file
+    std::vector<TickColumnChunk> get_chunks(uint8_t type, std::string_view column) const;
+
+    uint64_t get_row_count(uint8_t type) const;
+
+private:
+    void parse_footers();
+    // Offset of the last complete trailer; after a kill mid-flush a partial flush follows it
+    size_t find_trailer() const;
+    void parse_footer(uint64_t offset, uint64_t size);
+
+    struct ChunkRef {
+        uint8_t message_type;
+        uint8_t column;
+        TickColumnChunk chunk;
+    };
+
+    const uint8_t* m_mapped {nullptr};
+    size_t m_mapped_size {0};
+    std::array<std::vector<TickColumnInfo>, 256> m_columns;
+    std::vector<ChunkRef> m_chunks;
+};
+
+// Appends the values of an integer column chunk to out, widened to 64 bits
+void decode_tick_column(const TickColumnChunk& chunk, std::vector<uint64_t>& out);
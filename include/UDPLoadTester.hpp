@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+#include <LatencyHistogram.hpp>
+#include <UDPSocket.hpp>
+
+struct UDPLoadTestConfig {
+    std::string server_ip {"127.0.0.1"};
+    int port {8080};
+    size_t socket_count {16};
+    size_t max_in_flight {4096};
+    double requests_per_second {100000}; // 0 for closed loop: keep max_in_flight outstanding
+    std::chrono::milliseconds duration {5000};
+    std::chrono::milliseconds timeout {1000}; // Unanswered requests after this count as lost
+    size_t request_size {64}; // Bytes, including the 8-byte request id
+};
+
+struct UDPLoadTestResults {
+    uint64_t sent {0};
+    uint64_t completed {0};
+    uint64_t timed_out {0};
+    uint64_t unmatched {0}; // Responses with an unknown, repeated or already timed out request id
+    uint64_t in_flight_stalls {0}; // Send rounds held back because max_in_flight requests were outstanding
+    uint64_t socket_errors {0}; // e.g. ICMP port unreachable while the server is down
+    double elapsed_seconds {0};
+
+    /*
+    Response time runs from when a request was due under the constant-rate schedule, so
+    time spent queued behind a slow server is counted (no coordinated omission). Service
+    time runs from when it was actually sent. Closed-loop runs have no schedule, so the
+    two are the same.
+    */
+    LatencyHistogram response_time;
+    LatencyHistogram service_time;
+};
+
+/*
+Pipelined UDP request/response load generator.
+
+Requests are spread over socket_count connected, non-blocking sockets, all watched by one
+epoll instance, and sent and received in batches with sendmmsg/recvmmsg. Each request
+starts with a 64-bit id; the server must echo it back, which is all the matching needs.
+Outstanding requests live in a power-of-two ring indexed by id, so matching a response
+and expiring the oldest request are both constant time.
+*/
+class UDPLoadTester {
+public:
+    explicit UDPLoadTester(UDPLoadTestConfig config);
+    ~UDPLoadTester();
+
+    // The batch headers point into the object itself
+    UDPLoadTester(const UDPLoadTester&) = delete;
+    UDPLoadTester& operator=(const UDPLoadTester&) = delete;
+
+    // Runs the test for the configured duration, then waits up to one timeout for stragglers
+    UDPLoadTestResults run();
+
+private:
+    struct PendingRequest {
+        uint64_t id;
+        uint64_t due_ns;
+        uint64_t sent_ns;
+        bool outstanding;
+    };
+
+    static constexpr size_t SEND_BATCH_SIZE = 64;
+    static constexpr size_t RECEIVE_BATCH_SIZE = 64;
+    static constexpr size_t MAX_DATAGRAM_SIZE = 2048;
+
+    static uint64_t now_ns();
+
+    // Sends every request due by now, or in closed loop enough to fill the window
+    void send_due(uint64_t now, uint64_t end_ns, UDPLoadTestResults& results);
+    void receive_from(UDPSocket& socket, UDPLoadTestResults& results);
+    void expire(uint64_t now, UDPLoadTestResults& results);
+    uint64_t get_due_time(uint64_t id) const;
+
+    UDPLoadTestConfig m_config;
+    std::vector<UDPSocket> m_sockets;
+    int m_epoll_fd;
+    size_t m_next_socket {0};
+
+    std::vector<PendingRequest> m_pending;
+    uint64_t m_pending_mask;
+    uint64_t m_next_id {0}; // Next request to send
+    uint64_t m_oldest_id {0}; // No request before this one is still outstanding
+    size_t m_in_flight {0};
+    uint64_t m_start_ns {0};
+    uint64_t m_interval_ps {0}; // Picoseconds, so rates over 1e9/s don't truncate to 0; 0 for closed loop
+
+    // Send batch: every request is the same template with its id patched in
+    std::array<std::array<uint8_t, MAX_DATAGRAM_SIZE>, SEND_BATCH_SIZE> m_send_buffers {};
+    std::array<iovec, SEND_BATCH_SIZE> m_send_iovecs {};
+    std::array<mmsghdr, SEND_BATCH_SIZE> m_send_headers {};
+
+    std::array<std::array<uint8_t, MAX_DATAGRAM_SIZE>, RECEIVE_BATCH_SIZE> m_receive_buffers {};
+    std::array<iovec, RECEIVE_BATCH_SIZE> m_receive_iovecs {};
+    std::array<mmsghdr, RECEIVE_BATCH_SIZE> m_receive_headers {};
+};
+
+/*
+Stand-in for the UDP server: returns every datagram to its sender unchanged, a batch at a
+time. Meant for running the load tester locally.
+*/
+class UDPEchoServer {
+public:
+    explicit UDPEchoServer(int port);
+
+    UDPEchoServer(const UDPEchoServer&) = delete;
+    UDPEchoServer& operator=(const UDPEchoServer&) = delete;
+
+    // Serves until running is cleared; checks the flag at least every 100 ms
+    void run(const std::atomic<bool>& running);
+
+    uint64_t get_echoed_count() const { return m_echoed; }
+
+private:
+    static constexpr size_t BATCH_SIZE = 64;
+    static constexpr size_t MAX_DATAGRAM_SIZE = 2048;
+
+    UDPSocket m_socket;
+    uint64_t m_echoed {0};
+
+    std::array<std::array<uint8_t, MAX_DATAGRAM_SIZE>, BATCH_SIZE> m_buffers {};
+    std::array<iovec, BATCH_SIZE> m_iovecs {};
+    std::array<sockaddr_in, BATCH_SIZE> m_senders {};
+    std::array<mmsghdr, BATCH_SIZE> m_headers {};
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+struct mmsghdr;
+
 class UDPSocket {
 public:
     UDPSocket();
@@ -16,13 +18,29 @@ public:
     void set_reuse_address(bool enable);
     void set_multicast_ttl(int ttl);
     void set_multicast_loopback(bool enable);
+    void set_non_blocking(bool enable);
+    void set_receive_buffer_size(int bytes);
+    void set_send_buffer_size(int bytes);
 
     void join_multicast_group(const char* multicast_addr, const char* interface_addr = nullptr);
     void bind(sockaddr_in& addr);
 
+    // Fixes the peer: datagrams from anyone else are dropped and sends need no address
+    void connect(const sockaddr_in& addr);
+
     ssize_t send_to(const char* data, size_t len, const sockaddr_in& dest_addr);
+    // Returns -1 if a signal interrupted the wait before a datagram arrived
     ssize_t receive_from(char* buffer, size_t len, sockaddr_in& src_addr);
 
+    /*
+    Blocks until at least one datagram is available, then returns up to vlen of them.
+    Returns 0 if a signal interrupted the wait, or on a non-blocking socket with nothing to read.
+    */
+    int receive_many(mmsghdr* msgs, unsigned int vlen);
+
+    // Sends up to vlen datagrams in one system call and returns how many were sent (0 if a non-blocking socket is full)
+    int send_many(mmsghdr* msgs, unsigned int vlen);
+
 private:
     int m_socket_fd;
 };
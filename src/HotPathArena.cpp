@@ -0,0 +1,77 @@
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <HotPathArena.hpp>
+
+HotPathArena::HotPathArena(size_t capacity, std::pmr::memory_resource* upstream)
+    : m_capacity((capacity + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE)
+    , m_upstream(upstream) {
+
+    if (m_capacity == 0) {
+        throw std::invalid_argument("Arena capacity must not be zero");
+    }
+
+    void* base = mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    m_huge_pages = base != MAP_FAILED;
+
+    if (!m_huge_pages) {
+        // No reserved hugepages: ask for transparent ones instead
+        base = mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("Failed to map hot path arena");
+        }
+
+        madvise(base, m_capacity, MADV_HUGEPAGE);
+    }
+
+    m_base = static_cast<std::byte*>(base);
+    m_locked = mlock(m_base, m_capacity) == 0;
+
+    if (!m_locked) {
+        std::cerr << "Warning: Failed to lock hot path arena in memory (check RLIMIT_MEMLOCK)\n";
+    }
+
+    // Pre-fault: MAP_POPULATE is only a hint, a write to every page is not
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    for (size_t offset = 0; offset < m_capacity; offset += page_size) {
+        static_cast<volatile std::byte*>(m_base)[offset] = std::byte {0};
+    }
+}
+
+HotPathArena::~HotPathArena() {
+    if (m_locked) {
+        munlock(m_base, m_capacity);
+    }
+
+    munmap(m_base, m_capacity);
+}
+
+void* HotPathArena::do_allocate(size_t bytes, size_t alignment) {
+    size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+
+    if (offset + bytes > m_capacity) {
+        m_spills++;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    m_used = offset + bytes;
+    return m_base + offset;
+}
+
+void HotPathArena::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    std::byte* block = static_cast<std::byte*>(pointer);
+
+    // Arena memory is only reclaimed as a whole; spilled blocks go back upstream
+    if (block < m_base || block >= m_base + m_capacity) {
+        m_upstream->deallocate(pointer, bytes, alignment);
+    }
+}
+
+bool HotPathArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <LatencyHistogram.hpp>
+
+LatencyHistogram::LatencyHistogram(uint64_t highest_trackable, int significant_digits)
+    : m_highest_trackable(highest_trackable) {
+
+    if (significant_digits < 1 || significant_digits > 5) {
+        throw std::invalid_argument("Histogram precision must be 1 to 5 significant digits");
+    }
+
+    // Enough linear sub-buckets per power of two to resolve one unit in the last digit
+    int sub_bucket_count_magnitude = static_cast<int>(std::ceil(std::log2(2 * std::pow(10.0, significant_digits))));
+    uint64_t sub_bucket_count = uint64_t(1) << sub_bucket_count_magnitude;
+
+    if (highest_trackable < 2 * sub_bucket_count) {
+        throw std::invalid_argument("Highest trackable value too small for the requested precision");
+    }
+
+    m_sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+    m_sub_bucket_half_count = sub_bucket_count / 2;
+    m_sub_bucket_mask = sub_bucket_count - 1;
+
+    size_t bucket_count = 1;
+
+    for (uint64_t smallest_untrackable = sub_bucket_count; smallest_untrackable <= highest_trackable;
+         smallest_untrackable <<= 1) {
+        bucket_count++;
+
+        if (smallest_untrackable > UINT64_MAX / 2) {
+            break;
+        }
+    }
+
+    m_counts.assign((bucket_count + 1) * m_sub_bucket_half_count, 0);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.m_counts.size() != m_counts.size() || other.m_sub_bucket_mask != m_sub_bucket_mask) {
+        throw std::invalid_argument("Cannot merge histograms with different layouts");
+    }
+
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        m_counts[i] += other.m_counts[i];
+    }
+
+    m_total_count += other.m_total_count;
+    m_total_sum += other.m_total_sum;
+    m_saturated += other.m_saturated;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_total_count = 0;
+    m_total_sum = 0;
+    m_saturated = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+}
+
+uint64_t LatencyHistogram::get_value_at_percentile(double percentile) const {
+    if (m_total_count == 0) {
+        return 0;
+    }
+
+    double fraction = std::clamp(percentile, 0.0, 100.0) / 100.0;
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_total_count))));
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        seen += m_counts[i];
+
+        if (seen >= rank) {
+            return std::min(get_highest_equivalent_value(i), m_max);
+        }
+    }
+
+    return m_max;
+}
+
+double LatencyHistogram::get_mean() const {
+    return m_total_count ? static_cast<double>(m_total_sum) / static_cast<double>(m_total_count) : 0.0;
+}
+
+void LatencyHistogram::print_percentiles(std::ostream& out) const {
+    struct Percentile {
+        double value;
+        const char* label;
+    };
+
+    constexpr Percentile PERCENTILES[] = {
+        {50.0, "p50"}, {90.0, "p90"}, {99.0, "p99"}, {99.9, "p99.9"}, {99.99, "p99.99"}, {100.0, "max"}};
+
+    out << std::fixed << std::setprecision(1);
+
+    for (const Percentile& percentile : PERCENTILES) {
+        out << "  " << std::left << std::setw(8) << percentile.label << std::right << std::setw(12)
+            << get_value_at_percentile(percentile.value) / 1e3 << " us\n";
+    }
+
+    out << "  " << std::left << std::setw(8) << "mean" << std::right << std::setw(12) << get_mean() / 1e3 << " us\n";
+
+    if (m_saturated) {
+        out << "  (" << m_saturated << " values above " << m_highest_trackable / 1e3 << " us were clamped)\n";
+    }
+}
+
+uint64_t LatencyHistogram::get_highest_equivalent_value(size_t index) const {
+    int bucket = static_cast<int>(index >> m_sub_bucket_half_count_magnitude) - 1;
+    uint64_t sub_bucket = (index & (m_sub_bucket_half_count - 1)) + m_sub_bucket_half_count;
+
+    if (bucket < 0) {
+        sub_bucket -= m_sub_bucket_half_count;
+        bucket = 0;
+    }
+
+    return (sub_bucket << bucket) + (uint64_t(1) << bucket) - 1;
+}
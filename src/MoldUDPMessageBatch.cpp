@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <MoldUDPMessageBatch.hpp>
+#include <MoldUDPTransports.hpp>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// A full receive burst of average-sized ITCH messages fits without reallocating
+constexpr size_t INITIAL_MESSAGE_CAPACITY = RECEIVE_BATCH_SIZE * 64;
+
+}
+
+MoldUDPMessageBatch::MoldUDPMessageBatch(MessageKeyField key_field, std::pmr::memory_resource* memory)
+    : m_key_field(key_field)
+    , m_messages(memory)
+    , m_lengths(memory)
+    , m_sequences(memory)
+    , m_types(memory)
+    , m_keys(memory) {
+
+    set_key_field(key_field);
+    reserve_rows(INITIAL_MESSAGE_CAPACITY);
+}
+
+void MoldUDPMessageBatch::set_key_field(MessageKeyField key_field) {
+    if (key_field.width < 1 || key_field.width > 4) {
+        throw std::invalid_argument("Message key must be 1 to 4 bytes wide");
+    }
+
+    m_key_field = key_field;
+}
+
+void MoldUDPMessageBatch::reserve_rows(size_t rows) {
+    size_t capacity = std::max(rows, m_messages.size() * 2);
+
+    m_messages.resize(capacity);
+    m_lengths.resize(capacity);
+    m_sequences.resize(capacity);
+    m_types.resize(capacity);
+    m_keys.resize(capacity);
+}
+
+size_t select_by_type(const MoldUDPMessageBatch& batch, uint8_t type, uint32_t* selection) {
+    const uint8_t* types = batch.get_message_types().data();
+    size_t count = batch.size();
+    size_t selected = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // Compare 16 type bytes at a time and only visit the lanes that matched
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(type));
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(types + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+
+        while (mask) {
+            selection[selected++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        selection[selected] = static_cast<uint32_t>(i);
+        selected += types[i] == type;
+    }
+
+    return selected;
+}
+
+size_t select_by_types(const MoldUDPMessageBatch& batch, const bool (&types)[256], uint32_t* selection) {
+    const uint8_t* message_types = batch.get_message_types().data();
+    size_t count = batch.size();
+    size_t selected = 0;
+
+    // Branchless compaction: always write, only advance on a match
+    for (size_t i = 0; i < count; i++) {
+        selection[selected] = static_cast<uint32_t>(i);
+        selected += types[message_types[i]];
+    }
+
+    return selected;
+}
@@ -0,0 +1,100 @@
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <MoldUDPMessageStore.hpp>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MoldUDPMessageStore::MoldUDPMessageStore(uint64_t first_sequence)
+    : m_first_sequence(first_sequence) {}
+
+MoldUDPMessageStore::MoldUDPMessageStore(const char* path, uint64_t first_sequence)
+    : m_first_sequence(first_sequence) {
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open message store");
+    }
+
+    struct stat st {};
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error("Failed to stat message store");
+    }
+
+    m_mapped_size = static_cast<size_t>(st.st_size);
+
+    if (m_mapped_size > 0) {
+        void* mapped = mmap(nullptr, m_mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Failed to map message store");
+        }
+
+        m_mapped = static_cast<const uint8_t*>(mapped);
+    }
+
+    close(fd); // The mapping stays valid after the descriptor is closed
+
+    // Build the sequence index in one pass over the length prefixes
+    size_t offset = 0;
+
+    while (offset + sizeof(MoldUDP64MessageHeader) <= m_mapped_size) {
+        const MoldUDP64MessageHeader* msg_header =
+            reinterpret_cast<const MoldUDP64MessageHeader*>(m_mapped + offset);
+        size_t block_len = sizeof(MoldUDP64MessageHeader) + msg_header->get_message_length();
+
+        if (offset + block_len > m_mapped_size) {
+            break; // Trailing partial message (e.g. file still being written)
+        }
+
+        m_offsets.push_back(offset);
+        offset += block_len;
+    }
+}
+
+MoldUDPMessageStore::~MoldUDPMessageStore() {
+    if (m_mapped) {
+        munmap(const_cast<uint8_t*>(m_mapped), m_mapped_size);
+    }
+}
+
+void MoldUDPMessageStore::append(std::string_view message) {
+    if (m_mapped) {
+        throw std::logic_error("Cannot append to a memory-mapped message store");
+    }
+
+    if (message.size() > UINT16_MAX) {
+        throw std::invalid_argument("Message too long for MoldUDP64");
+    }
+
+    MoldUDP64MessageHeader msg_header {};
+    msg_header.set_message_length(static_cast<uint16_t>(message.size()));
+
+    size_t offset = m_owned.size();
+    m_owned.resize(offset + sizeof(msg_header) + message.size());
+    std::memcpy(m_owned.data() + offset, &msg_header, sizeof(msg_header));
+    std::memcpy(m_owned.data() + offset + sizeof(msg_header), message.data(), message.size());
+
+    m_offsets.push_back(offset);
+}
+
+void MoldUDPMessageStore::save(const char* path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+
+    if (!out) {
+        throw std::runtime_error("Failed to create message store file");
+    }
+
+    size_t size = m_mapped ? m_mapped_size : m_owned.size();
+    out.write(reinterpret_cast<const char*>(data()), static_cast<std::streamsize>(size));
+
+    if (!out) {
+        throw std::runtime_error("Failed to write message store file");
+    }
+}
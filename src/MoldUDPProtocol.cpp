@@ -0,0 +1,66 @@
+#include <cstring>
+#include <MoldUDPProtocol.hpp>
+#include <stdexcept>
+
+MoldUDPPacketBuilder::MoldUDPPacketBuilder(std::string_view session, uint64_t first_sequence, size_t max_size)
+    : m_buffer(sizeof(MoldUDP64PacketHeader))
+    , m_max_size(max_size)
+    , m_first_sequence(first_sequence) {
+
+    if (max_size < sizeof(MoldUDP64PacketHeader)) {
+        throw std::invalid_argument("Packet size too small for MoldUDP header");
+    }
+
+    m_buffer.reserve(max_size);
+    header().set_session(session);
+    reset(first_sequence);
+}
+
+bool MoldUDPPacketBuilder::add_message(std::string_view message) {
+    size_t needed = sizeof(MoldUDP64MessageHeader) + message.size();
+
+    if (m_buffer.size() + needed > m_max_size || message.size() > UINT16_MAX
+        || m_message_count == MOLD_UDP_END_OF_SESSION - 1) {
+        return false;
+    }
+
+    MoldUDP64MessageHeader msg_header {};
+    msg_header.set_message_length(static_cast<uint16_t>(message.size()));
+
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + needed);
+    std::memcpy(m_buffer.data() + offset, &msg_header, sizeof(msg_header));
+    std::memcpy(m_buffer.data() + offset + sizeof(msg_header), message.data(), message.size());
+
+    header().set_message_count(++m_message_count);
+    return true;
+}
+
+void MoldUDPPacketBuilder::reset(uint64_t first_sequence) {
+    m_buffer.resize(sizeof(MoldUDP64PacketHeader));
+    m_first_sequence = first_sequence;
+    m_message_count = 0;
+
+    header().set_sequence_number(first_sequence);
+    header().set_message_count(0);
+}
+
+uint64_t MoldUDPPacketBuilder::get_next_sequence_number() const {
+    return m_first_sequence + m_message_count;
+}
+
+uint16_t MoldUDPPacketBuilder::get_message_count() const {
+    return m_message_count;
+}
+
+size_t MoldUDPPacketBuilder::get_size() const {
+    return m_buffer.size();
+}
+
+std::span<const uint8_t> MoldUDPPacketBuilder::get_packet() const {
+    return {m_buffer.data(), m_buffer.size()};
+}
+
+MoldUDP64PacketHeader& MoldUDPPacketBuilder::header() {
+    return *reinterpret_cast<MoldUDP64PacketHeader*>(m_buffer.data());
+}
@@ -1,125 +1,74 @@
-#include <algorithm>
 #include <arpa/inet.h>
-#include <array>
 #include <iostream>
+#include <string>
 #include <MoldUDPReceiver.hpp>
-#include <stdexcept>
-#include <UDPSocket.hpp>
 
-constexpr int MAX_PACKET_SIZE = 1400;
+void PrintingHandler::on_datagram(const sockaddr_in& sender, size_t length) {
+    if (m_warming_up) {
+        return;
+    }
 
-std::string MoldUDP64PacketHeader::get_session() const {
-    return std::string(m_session, 10);
-}
+    // Convert sender IP to string for display
+    char sender_ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &sender.sin_addr, sender_ip, INET_ADDRSTRLEN);
 
-void MoldUDP64PacketHeader::set_session(std::string_view session) {
-    std::fill(std::begin(m_session), std::end(m_session), ' '); // Any unused bytes are space-padded as per spec
-    std::copy_n(session.data(), std::min(session.size(), size_t(10)), m_session);
+    std::cout << "\n=== Received UDP packet from " << sender_ip
+                << ":" << ntohs(sender.sin_port)
+                << " (" << length << " bytes) ===\n";
 }
 
-uint64_t MoldUDP64PacketHeader::get_sequence_number() const {
-    return be64toh(m_sequence_number);
-}
+void PrintingHandler::on_packet(const MoldUDP64PacketHeader& header) {
+    if (m_warming_up) {
+        return;
+    }
 
-void MoldUDP64PacketHeader::set_sequence_number(uint64_t seq_num) {
-    m_sequence_number = htobe64(seq_num);
-}
+    std::cout << "Session: '" << header.get_session() << "'\n";
+    std::cout << "Sequence: " << header.get_sequence_number() << "\n";
+    std::cout << "Message Count: " << header.get_message_count() << "\n";
 
-uint16_t MoldUDP64PacketHeader::get_message_count() const {
-    return ntohs(m_message_count);
+    m_message_index = 0;
 }
 
+void PrintingHandler::on_message(uint64_t, std::string_view message) {
+    if (m_warming_up) {
+        return;
+    }
 
-void MoldUDP64PacketHeader::set_message_count(uint16_t msg_count) {
-    m_message_count = htons(msg_count);
+    std::cout << "  Message " << ++m_message_index << " [" << message.size() << " bytes]: " << message << "\n";
 }
 
-uint16_t MoldUDP64MessageHeader::get_message_length() const {
-    return ntohs(message_length);
-}
+void PrintingHandler::on_error(const char* what) {
+    if (m_warming_up) {
+        return;
+    }
 
-void MoldUDP64MessageHeader::set_message_length(uint16_t len) {
-    message_length = htons(len);
+    std::cerr << what << "\n";
 }
 
-MoldUDPReceiver::MoldUDPReceiver(const char* multicast_addr, int port, const char* interface_addr) 
-    : m_socket()
-    , m_multicast_addr(multicast_addr) {
-
-    m_socket.set_reuse_address(true);
-
-    m_local_addr = {};
-    m_local_addr.sin_family = AF_INET;
-    m_local_addr.sin_port = htons(port);
-    m_local_addr.sin_addr.s_addr = INADDR_ANY;
-
-    m_socket.bind(m_local_addr);
+std::vector<std::vector<uint8_t>> make_warm_up_packets(size_t packet_count) {
+    constexpr size_t MESSAGE_SIZE = 36; // ITCH 5.0 Add Order
+    constexpr uint16_t LOCATE_COUNT = 8192;
+
+    std::vector<std::vector<uint8_t>> packets;
+    MoldUDPPacketBuilder builder(MOLD_UDP_WARM_UP_SESSION, 1);
+    std::string message(MESSAGE_SIZE, '\0');
+    uint32_t counter = 0;
+
+    while (packets.size() < packet_count) {
+        uint16_t locate = static_cast<uint16_t>((counter * 2654435761u) % LOCATE_COUNT + 1);
+        message[0] = "AEXDUFPC"[counter % 8];
+        message[1] = static_cast<char>(locate >> 8);
+        message[2] = static_cast<char>(locate & 0xFF);
+
+        if (!builder.add_message(message)) {
+            auto packet = builder.get_packet();
+            packets.emplace_back(packet.begin(), packet.end());
+            builder.reset(builder.get_next_sequence_number());
+            continue;
+        }
 
-    m_socket.join_multicast_group(multicast_addr, interface_addr);
-        
-    std::cout << "MoldUDP Multicast Receiver started\n";
-    std::cout << "Listening to multicast group: " << multicast_addr 
-                << ":" << port << "\n";
-    if (interface_addr) {
-        std::cout << "On interface: " << interface_addr << "\n";
-    } else {
-        std::cout << "On all interfaces\n";
+        counter++;
     }
-}
 
-void MoldUDPReceiver::receive_and_process() {
-    std::array<char, MAX_PACKET_SIZE> buffer {};
-    sockaddr_in sender_addr {};
-    
-    ssize_t received = m_socket.receive_from(buffer.data(), buffer.size(), sender_addr);
-    
-    // Convert sender IP to string for display
-    char sender_ip[INET_ADDRSTRLEN];
-    inet_ntop(AF_INET, &sender_addr.sin_addr, sender_ip, INET_ADDRSTRLEN);
-    
-    std::cout << "\n=== Received UDP packet from " << sender_ip 
-                << ":" << ntohs(sender_addr.sin_port) 
-                << " (" << received << " bytes) ===\n";
-    
-    if (received < static_cast<ssize_t>(sizeof(MoldUDP64PacketHeader))) {
-        std::cerr << "Packet too small for MoldUDP header\n";
-        return;
-    }
-    
-    const MoldUDP64PacketHeader* session_header = 
-        reinterpret_cast<const MoldUDP64PacketHeader*>(buffer.data());
-    
-    std::cout << "Session: '" << session_header->get_session() << "'\n";
-    std::cout << "Sequence: " << session_header->get_sequence_number() << "\n";
-    std::cout << "Message Count: " << session_header->get_message_count() << "\n";
-    
-    size_t offset = sizeof(MoldUDP64PacketHeader);
-    uint16_t msg_count = session_header->get_message_count();
-    
-    for (int i = 0; i < msg_count; i++) {
-        if (offset + sizeof(MoldUDP64MessageHeader) > static_cast<size_t>(received)) {
-            std::cerr << "Incomplete message header\n";
-            break;
-        }
-        
-        const MoldUDP64MessageHeader* msg_header = 
-            reinterpret_cast<const MoldUDP64MessageHeader*>(buffer.data() + offset);
-        offset += sizeof(MoldUDP64MessageHeader);
-        
-        uint16_t msg_len = msg_header->get_message_length();
-        
-        if (offset + msg_len > static_cast<size_t>(received)) {
-            std::cerr << "Incomplete message data\n";
-            break;
-        }
-        
-        std::string_view message(buffer.data() + offset, msg_len);
-        std::cout << "  Message " << (i + 1) << " [" << msg_len << " bytes]: " << message << "\n";
-        
-        offset += msg_len;
-    }
+    return packets;
 }
-
-const std::string& MoldUDPReceiver::get_multicast_address() const {
-    return m_multicast_addr;
-}
\ No newline at end of file
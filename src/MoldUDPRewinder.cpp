@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <iostream>
+#include <MoldUDPRewinder.hpp>
+#include <stdexcept>
+
+namespace {
+
+// Identifies where a response goes; the rate limit is by IP alone
+uint64_t client_key(const sockaddr_in& client) {
+    return (static_cast<uint64_t>(client.sin_addr.s_addr) << 16) | client.sin_port;
+}
+
+}
+
+MoldUDPRewinder::MoldUDPRewinder(const MoldUDPMessageStore& store, MoldUDPRewinderConfig config)
+    : m_store(store)
+    , m_config(std::move(config))
+    , m_socket()
+    , m_builder(m_config.session, store.get_first_sequence_number(), m_config.max_packet_size)
+    , m_last_eviction(std::chrono::steady_clock::now()) {
+
+    m_session_header.set_session(m_config.session);
+
+    sockaddr_in local_addr {};
+    local_addr.sin_family = AF_INET;
+    local_addr.sin_port = htons(m_config.port);
+    local_addr.sin_addr.s_addr = INADDR_ANY;
+
+    m_socket.bind(local_addr);
+
+    for (size_t i = 0; i < REQUEST_BATCH_SIZE; i++) {
+        m_request_iovecs[i] = {m_request_buffers[i].data(), m_request_buffers[i].size()};
+
+        msghdr& hdr = m_request_headers[i].msg_hdr;
+        hdr.msg_iov = &m_request_iovecs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = &m_request_senders[i];
+        hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    for (size_t i = 0; i < SEND_BATCH_SIZE; i++) {
+        msghdr& hdr = m_send_headers[i].msg_hdr;
+        hdr.msg_iov = &m_send_iovecs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = &m_send_dests[i];
+        hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    std::cout << "MoldUDP rewinder started for session '" << m_config.session << "'\n";
+    std::cout << "Serving sequence numbers " << m_store.get_first_sequence_number() << " to "
+                << m_store.get_end_sequence_number() - 1 << " on port " << m_config.port << "\n";
+}
+
+void MoldUDPRewinder::serve_once() {
+    int received = m_socket.receive_many(m_request_headers.data(), REQUEST_BATCH_SIZE);
+    auto now = std::chrono::steady_clock::now();
+
+    m_pending.clear();
+
+    for (int i = 0; i < received; i++) {
+        m_stats.requests++;
+
+        const sockaddr_in& client = m_request_senders[i];
+        size_t length = m_request_headers[i].msg_len;
+        m_request_headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in); // Value-result, reset for next call
+
+        const MoldUDP64PacketHeader* request =
+            reinterpret_cast<const MoldUDP64PacketHeader*>(m_request_buffers[i].data());
+
+        if (length != sizeof(MoldUDP64PacketHeader)
+            || std::memcmp(request->m_session, m_session_header.m_session, MOLD_UDP_SESSION_LENGTH) != 0) {
+            m_stats.malformed++;
+            continue;
+        }
+
+        uint64_t begin = request->get_sequence_number();
+        uint64_t end = std::min(begin + request->get_message_count(), m_store.get_end_sequence_number());
+        begin = std::max(begin, m_store.get_first_sequence_number());
+
+        if (begin >= end) {
+            m_stats.out_of_range++;
+            continue;
+        }
+
+        end = std::min(end, begin + m_config.max_messages_per_request);
+        m_pending.push_back({client_key(client), client, begin, end});
+    }
+
+    // Merge overlapping or adjacent ranges from the same requester
+    std::sort(m_pending.begin(), m_pending.end(), [](const PendingRange& a, const PendingRange& b) {
+        return a.client_key != b.client_key ? a.client_key < b.client_key : a.begin < b.begin;
+    });
+
+    size_t merged = 0;
+
+    for (size_t i = 0; i < m_pending.size(); i++) {
+        if (merged > 0 && m_pending[merged - 1].client_key == m_pending[i].client_key
+            && m_pending[i].begin <= m_pending[merged - 1].end) {
+            m_pending[merged - 1].end = std::max(m_pending[merged - 1].end, m_pending[i].end);
+            m_stats.coalesced++;
+            continue;
+        }
+
+        m_pending[merged++] = m_pending[i];
+    }
+
+    m_pending.resize(merged);
+
+    // Charge each merged range once, so duplicate requests are not billed twice
+    for (const PendingRange& range : m_pending) {
+        uint32_t client_ip = range.client_addr.sin_addr.s_addr;
+        uint64_t end = range.begin + admit(client_ip, range.end - range.begin, now);
+        uint64_t sequence = range.begin;
+
+        if (end == range.begin) {
+            m_stats.throttled++;
+            continue;
+        }
+
+        while (sequence < end) {
+            const BuiltPacket* packet = packet_starting_at(sequence, end);
+
+            if (packet == nullptr) {
+                m_stats.oversized++;
+                refund(client_ip, end - sequence);
+                break;
+            }
+
+            queue_send(*packet, range.client_addr);
+            sequence = packet->end;
+        }
+    }
+
+    flush_sends();
+
+    m_packets.clear();
+    m_packets_by_begin.clear();
+
+    if (now - m_last_eviction > m_config.client_idle_timeout) {
+        evict_idle_clients(now);
+    }
+}
+
+const MoldUDPRewinderStats& MoldUDPRewinder::get_stats() const {
+    return m_stats;
+}
+
+uint64_t MoldUDPRewinder::admit(uint32_t client_ip, uint64_t count, std::chrono::steady_clock::time_point now) {
+    auto [it, inserted] = m_clients.try_emplace(client_ip, ClientState{m_config.client_burst_messages, now});
+    ClientState& state = it->second;
+
+    double elapsed = std::chrono::duration<double>(now - state.last_seen).count();
+    state.tokens = std::min(m_config.client_burst_messages,
+        state.tokens + elapsed * m_config.client_messages_per_second);
+    state.last_seen = now;
+
+    uint64_t allowed = std::min(count, static_cast<uint64_t>(state.tokens));
+    state.tokens -= static_cast<double>(allowed);
+
+    return allowed;
+}
+
+void MoldUDPRewinder::refund(uint32_t client_ip, uint64_t count) {
+    ClientState& state = m_clients.at(client_ip);
+    state.tokens = std::min(m_config.client_burst_messages, state.tokens + static_cast<double>(count));
+}
+
+const MoldUDPRewinder::BuiltPacket* MoldUDPRewinder::packet_starting_at(uint64_t begin, uint64_t end) {
+    auto cached = m_packets_by_begin.find(begin);
+
+    // Reuse a packet another requester already triggered, as long as it doesn't overshoot this range
+    if (cached != m_packets_by_begin.end() && cached->second->end <= end) {
+        return cached->second;
+    }
+
+    m_builder.reset(begin);
+    uint64_t sequence = begin;
+
+    while (sequence < end && m_builder.add_message(m_store.get(sequence))) {
+        sequence++;
+    }
+
+    if (sequence == begin) {
+        // Skipping it would leave a silent hole; the requester sees the response end here instead
+        std::cerr << "MoldUDP rewinder: message " << begin << " does not fit in a " << m_config.max_packet_size
+                  << " byte packet\n";
+        return nullptr;
+    }
+
+    std::span<const uint8_t> bytes = m_builder.get_packet();
+    m_packets.push_back({std::vector<uint8_t>(bytes.begin(), bytes.end()), sequence, m_builder.get_message_count()});
+    m_packets_by_begin[begin] = &m_packets.back();
+
+    return &m_packets.back();
+}
+
+void MoldUDPRewinder::queue_send(const BuiltPacket& packet, const sockaddr_in& dest) {
+    m_send_iovecs[m_send_count] = {const_cast<uint8_t*>(packet.bytes.data()), packet.bytes.size()};
+    m_send_dests[m_send_count] = dest;
+    m_send_count++;
+
+    m_stats.messages_sent += packet.message_count;
+
+    if (m_send_count == SEND_BATCH_SIZE) {
+        flush_sends();
+    }
+}
+
+void MoldUDPRewinder::flush_sends() {
+    size_t done = 0;
+
+    while (done < m_send_count) {
+        try {
+            int sent = m_socket.send_many(&m_send_headers[done], static_cast<unsigned int>(m_send_count - done));
+            m_stats.packets_sent += sent;
+            done += sent;
+        } catch (const std::runtime_error&) {
+            m_stats.send_errors++;
+            done++; // Skip the datagram that failed, keep serving everyone else
+        }
+    }
+
+    m_send_count = 0;
+}
+
+void MoldUDPRewinder::evict_idle_clients(std::chrono::steady_clock::time_point now) {
+    std::erase_if(m_clients, [&](const auto& entry) {
+        return now - entry.second.last_seen > m_config.client_idle_timeout;
+    });
+
+    m_last_eviction = now;
+}
@@ -0,0 +1,208 @@
+#include <arpa/inet.h>
+#include <iostream>
+#include <MoldUDPTransports.hpp>
+#include <stdexcept>
+
+namespace {
+
+void print_listening(const char* kind, const char* multicast_addr, int port, const char* interface_addr) {
+    std::cout << "MoldUDP Multicast Receiver started (" << kind << ")\n";
+    std::cout << "Listening to multicast group: " << multicast_addr
+                << ":" << port << "\n";
+    if (interface_addr) {
+        std::cout << "On interface: " << interface_addr << "\n";
+    } else {
+        std::cout << "On all interfaces\n";
+    }
+}
+
+}
+
+MulticastSocket::MulticastSocket(const char* multicast_addr, int port, const char* interface_addr)
+    : m_multicast_addr(multicast_addr)
+    , m_interface_addr(interface_addr ? interface_addr : "") {
+
+    m_socket.set_reuse_address(true);
+
+    sockaddr_in local_addr {};
+    local_addr.sin_family = AF_INET;
+    local_addr.sin_port = htons(port);
+    local_addr.sin_addr.s_addr = INADDR_ANY;
+
+    m_socket.bind(local_addr);
+}
+
+void MulticastSocket::join() {
+    if (m_joined) {
+        return;
+    }
+
+    m_socket.join_multicast_group(m_multicast_addr.c_str(),
+        m_interface_addr.empty() ? nullptr : m_interface_addr.c_str());
+    m_joined = true;
+}
+
+SocketTransport::SocketTransport(const char* multicast_addr, int port, const char* interface_addr,
+    std::pmr::memory_resource* memory)
+    : m_socket(multicast_addr, port, interface_addr)
+    , m_buffer(make_from_resource<std::array<uint8_t, MAX_PACKET_SIZE>>(memory)) {
+
+    print_listening("recvfrom", multicast_addr, port, interface_addr);
+}
+
+void SocketTransport::join() {
+    m_socket.join();
+}
+
+const std::string& SocketTransport::get_multicast_address() const {
+    return m_socket.get_multicast_address();
+}
+
+RecvmmsgTransport::RecvmmsgTransport(const char* multicast_addr, int port, const char* interface_addr,
+    std::pmr::memory_resource* memory)
+    : m_socket(multicast_addr, port, interface_addr)
+    , m_batch(make_from_resource<Batch>(memory)) {
+
+    for (size_t i = 0; i < RECEIVE_BATCH_SIZE; i++) {
+        m_batch->iovecs[i] = {m_batch->buffers[i].data(), m_batch->buffers[i].size()};
+
+        msghdr& hdr = m_batch->headers[i].msg_hdr;
+        hdr.msg_iov = &m_batch->iovecs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = &m_batch->senders[i];
+        hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+
+    print_listening("recvmmsg", multicast_addr, port, interface_addr);
+}
+
+void RecvmmsgTransport::join() {
+    m_socket.join();
+}
+
+const std::string& RecvmmsgTransport::get_multicast_address() const {
+    return m_socket.get_multicast_address();
+}
+
+#ifdef MOLD_UDP_HAS_IO_URING
+IoUringTransport::IoUringTransport(const char* multicast_addr, int port, const char* interface_addr,
+    std::pmr::memory_resource* memory)
+    : m_socket(multicast_addr, port, interface_addr)
+    , m_ring(make_from_resource<Ring>(memory)) {
+
+    if (io_uring_queue_init(RECEIVE_BATCH_SIZE, &m_ring->ring, 0) < 0) {
+        throw std::runtime_error("Failed to initialize io_uring");
+    }
+
+    for (size_t i = 0; i < RECEIVE_BATCH_SIZE; i++) {
+        m_ring->iovecs[i] = {m_ring->buffers[i].data(), m_ring->buffers[i].size()};
+
+        msghdr& hdr = m_ring->headers[i];
+        hdr.msg_iov = &m_ring->iovecs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = &m_ring->senders[i];
+
+        arm(i);
+    }
+
+    io_uring_submit(&m_ring->ring);
+
+    print_listening("io_uring", multicast_addr, port, interface_addr);
+}
+
+IoUringTransport::~IoUringTransport() {
+    if (m_ring) {
+        io_uring_queue_exit(&m_ring->ring);
+    }
+}
+
+void IoUringTransport::join() {
+    m_socket.join();
+}
+
+const std::string& IoUringTransport::get_multicast_address() const {
+    return m_socket.get_multicast_address();
+}
+#endif
+
+#ifdef MOLD_UDP_HAS_PCAP
+PcapTransport::PcapTransport(const char* source, const char* multicast_addr, int port)
+    : m_handle(nullptr)
+    , m_multicast_addr(multicast_addr)
+    , m_port(htons(port)) {
+
+    if (inet_pton(AF_INET, multicast_addr, &m_multicast_ip) != 1) {
+        throw std::runtime_error("Invalid multicast address");
+    }
+
+    char errbuf[PCAP_ERRBUF_SIZE];
+    m_handle = pcap_open_offline(source, errbuf);
+
+    if (m_handle == nullptr) {
+        m_handle = pcap_open_live(source, 65535, 1, 1, errbuf);
+    }
+
+    if (m_handle == nullptr) {
+        throw std::runtime_error("Failed to open capture source");
+    }
+
+    if (pcap_datalink(m_handle) != DLT_EN10MB) {
+        pcap_close(m_handle);
+        throw std::runtime_error("Capture source is not Ethernet");
+    }
+
+    std::cout << "MoldUDP Multicast Receiver started (pcap)\n";
+    std::cout << "Reading multicast group " << multicast_addr << ":" << port
+                << " from " << source << "\n";
+}
+
+PcapTransport::~PcapTransport() {
+    if (m_handle) {
+        pcap_close(m_handle);
+    }
+}
+
+PcapTransport::PcapTransport(PcapTransport&& other) noexcept
+    : m_handle(other.m_handle)
+    , m_multicast_addr(std::move(other.m_multicast_addr))
+    , m_multicast_ip(other.m_multicast_ip)
+    , m_port(other.m_port)
+    , m_exhausted(other.m_exhausted) {
+    other.m_handle = nullptr;
+}
+
+PcapTransport& PcapTransport::operator=(PcapTransport&& other) noexcept {
+    if (this != &other) {
+        if (m_handle) {
+            pcap_close(m_handle);
+        }
+        m_handle = other.m_handle;
+        m_multicast_addr = std::move(other.m_multicast_addr);
+        m_multicast_ip = other.m_multicast_ip;
+        m_port = other.m_port;
+        m_exhausted = other.m_exhausted;
+        other.m_handle = nullptr;
+    }
+
+    return *this;
+}
+
+bool PcapTransport::is_exhausted() const {
+    return m_exhausted;
+}
+
+const std::string& PcapTransport::get_multicast_address() const {
+    return m_multicast_addr;
+}
+#endif
+
+ReplayTransport::ReplayTransport(std::vector<std::vector<uint8_t>> packets)
+    : m_packets(std::move(packets)) {
+
+    m_sender.sin_family = AF_INET;
+    m_sender.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+const std::string& ReplayTransport::get_multicast_address() const {
+    return m_multicast_addr;
+}
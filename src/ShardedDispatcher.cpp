@@ -0,0 +1,17 @@
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <ShardedDispatcher.hpp>
+
+bool pin_thread_to_cpu(std::thread& thread, int cpu) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) != 0) {
+        std::cerr << "Warning: Failed to pin worker thread to CPU " << cpu << "\n";
+        return false;
+    }
+
+    return true;
+}
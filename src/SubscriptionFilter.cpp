@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <SubscriptionFilter.hpp>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SUBSCRIPTION_FILTER_HAS_AVX2_KERNEL
+#endif
+
+SubscriptionFilter::SubscriptionFilter(uint32_t key_space)
+    : m_key_space(key_space > 0 && key_space <= (1u << 24) ? key_space
+        : throw std::invalid_argument("Subscription key space must be between 1 and 2^24"))
+    , m_word_count(key_space / 64 + 1) // One extra bit for the out-of-range sentinel
+    , m_words(std::make_unique<std::atomic<uint64_t>[]>(m_word_count)) {
+
+    clear();
+}
+
+void SubscriptionFilter::subscribe(uint32_t key) {
+    if (key >= m_key_space) {
+        throw std::out_of_range("Subscription key outside the key space");
+    }
+
+    m_words[key >> 6].fetch_or(uint64_t(1) << (key & 63), std::memory_order_relaxed);
+}
+
+void SubscriptionFilter::unsubscribe(uint32_t key) {
+    if (key >= m_key_space) {
+        return;
+    }
+
+    m_words[key >> 6].fetch_and(~(uint64_t(1) << (key & 63)), std::memory_order_relaxed);
+}
+
+void SubscriptionFilter::subscribe_all() {
+    for (uint32_t key = 0; key < m_key_space; key += 64) {
+        uint32_t bits = std::min(64u, m_key_space - key);
+        m_words[key >> 6].store(bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1, std::memory_order_relaxed);
+    }
+}
+
+void SubscriptionFilter::clear() {
+    for (size_t i = 0; i < m_word_count; i++) {
+        m_words[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t SubscriptionFilter::get_subscription_count() const {
+    size_t count = 0;
+
+    for (size_t i = 0; i < m_word_count; i++) {
+        count += std::popcount(m_words[i].load(std::memory_order_relaxed));
+    }
+
+    return count;
+}
+
+namespace {
+
+// Branchless compaction from row i on: always write, only advance on a match
+size_t select_subscribed_scalar(const uint32_t* keys, size_t i, size_t count, const SubscriptionFilter& filter,
+    uint32_t* selection, size_t selected) {
+    for (; i < count; i++) {
+        selection[selected] = static_cast<uint32_t>(i);
+        selected += filter.contains(keys[i]);
+    }
+
+    return selected;
+}
+
+#ifdef SUBSCRIPTION_FILTER_HAS_AVX2_KERNEL
+/*
+Eight keys per step: clamp to the sentinel, gather the 32-bit half-words holding each bit,
+shift the bit down and turn the result into a lane mask. Relaxed atomic loads of a
+lock-free 64-bit word compile to plain loads, so reading the (little-endian) bitmap as
+32-bit lanes is equivalent to calling contains() on each key.
+Compiled for AVX2 whatever the build's -march; only called when the CPU has it.
+*/
+__attribute__((target("avx2")))
+size_t select_subscribed_avx2(const uint32_t* keys, size_t count, const SubscriptionFilter& filter, uint32_t* selection) {
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    const int* bitmap = reinterpret_cast<const int*>(filter.get_words());
+    const __m256i limit = _mm256_set1_epi32(static_cast<int>(filter.get_key_space()));
+    const __m256i low_bits = _mm256_set1_epi32(31);
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t selected = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        key = _mm256_min_epu32(key, limit);
+
+        __m256i word = _mm256_i32gather_epi32(bitmap, _mm256_srli_epi32(key, 5), 4);
+        __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(key, low_bits)), one);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(bit, 31))));
+
+        while (mask) {
+            selection[selected++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+
+    return select_subscribed_scalar(keys, i, count, filter, selection, selected);
+}
+
+const bool CPU_HAS_AVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+}
+
+size_t select_subscribed(const MoldUDPMessageBatch& batch, const SubscriptionFilter& filter, uint32_t* selection) {
+    const uint32_t* keys = batch.get_keys().data();
+    size_t count = batch.size();
+
+#ifdef SUBSCRIPTION_FILTER_HAS_AVX2_KERNEL
+    if (CPU_HAS_AVX2) {
+        return select_subscribed_avx2(keys, count, filter, selection);
+    }
+#endif
+
+    return select_subscribed_scalar(keys, 0, count, filter, selection, 0);
+}
@@ -0,0 +1,850 @@
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <TickCapture.hpp>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'T', 'I', 'C', 'K', 'C', 'A', 'P', '1'};
+constexpr std::string_view SEQUENCE_COLUMN = "sequence";
+constexpr size_t TRAILER_SIZE = 2 * sizeof(uint64_t) + sizeof(FILE_MAGIC);
+constexpr size_t MAPPING_GROWTH = 64 * 1024 * 1024;
+constexpr size_t CHUNK_ALIGNMENT = 8;
+constexpr size_t RELEASE_INTERVAL = 256; // Popped slots handed back to the receive thread at once
+constexpr size_t FLUSH_CHECK_INTERVAL = 4096; // Messages between flush timer checks while busy
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(100);
+
+size_t get_column_width(TickColumnType type) {
+    switch (type) {
+    case TickColumnType::UINT8:
+        return 1;
+    case TickColumnType::UINT16:
+        return 2;
+    case TickColumnType::UINT32:
+        return 4;
+    case TickColumnType::UINT64:
+    case TickColumnType::CHAR8:
+        return 8;
+    }
+
+    throw std::invalid_argument("Unknown tick column type");
+}
+
+uint64_t read_big_endian(const uint8_t* data, size_t width) {
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < width; i++) {
+        value = (value << 8) | data[i];
+    }
+
+    return value;
+}
+
+template <typename T>
+void put(std::vector<uint8_t>& out, T value) {
+    size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t zigzag_encode(uint64_t delta) {
+    return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+}
+
+uint64_t zigzag_decode(uint64_t value) {
+    return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+// Bounds-checked reads from the footer
+class FooterCursor {
+public:
+    FooterCursor(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    const uint8_t* take(size_t size) {
+        if (size > m_size - m_offset) {
+            throw std::runtime_error("Truncated tick capture footer");
+        }
+
+        const uint8_t* data = m_data + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset {0};
+};
+
+std::vector<TickFieldSpec> with_itch_header(std::initializer_list<TickFieldSpec> fields) {
+    std::vector<TickFieldSpec> all {
+        {"stock_locate", 1, 2, TickColumnType::UINT16},
+        {"tracking_number", 3, 2, TickColumnType::UINT16},
+        {"timestamp", 5, 6, TickColumnType::UINT64}, // Nanoseconds since midnight
+    };
+
+    all.insert(all.end(), fields);
+    return all;
+}
+
+}
+
+void TickCaptureSchema::add_message_type(uint8_t type, std::vector<TickFieldSpec> fields) {
+    if (fields.empty() || fields.size() > UINT8_MAX - 1) {
+        throw std::invalid_argument("A captured message type needs 1 to 254 fields");
+    }
+
+    for (const TickFieldSpec& field : fields) {
+        size_t width = get_column_width(field.type);
+
+        if (field.width == 0 || field.width > width || (field.type == TickColumnType::CHAR8 && field.width != width)) {
+            throw std::invalid_argument("Field width does not fit its column type: " + field.name);
+        }
+
+        if (field.offset + field.width > MAX_TICK_MESSAGE_SIZE) {
+            throw std::invalid_argument("Field lies beyond the largest captured message: " + field.name);
+        }
+
+        if (field.name.empty() || field.name.size() > UINT8_MAX || field.name == SEQUENCE_COLUMN) {
+            throw std::invalid_argument("Invalid field name: " + field.name);
+        }
+    }
+
+    m_fields[type] = std::move(fields);
+}
+
+TickCaptureSchema TickCaptureSchema::itch50() {
+    using enum TickColumnType;
+    TickCaptureSchema schema;
+
+    schema.add_message_type('S', with_itch_header({{"event_code", 11, 1, UINT8}}));
+    schema.add_message_type('A', with_itch_header({
+        {"order_reference", 11, 8, UINT64},
+        {"side", 19, 1, UINT8},
+        {"shares", 20, 4, UINT32},
+        {"stock", 24, 8, CHAR8},
+        {"price", 32, 4, UINT32},
+    }));
+    schema.add_message_type('F', with_itch_header({
+        {"order_reference", 11, 8, UINT64},
+        {"side", 19, 1, UINT8},
+        {"shares", 20, 4, UINT32},
+        {"stock", 24, 8, CHAR8},
+        {"price", 32, 4, UINT32},
+        {"attribution", 36, 4, UINT32},
+    }));
+    schema.add_message_type('E', with_itch_header({
+        {"order_reference", 11, 8, UINT64},
+        {"executed_shares", 19, 4, UINT32},
+        {"match_number", 23, 8, UINT64},
+    }));
+    schema.add_message_type('C', with_itch_header({
+        {"order_reference", 11, 8, UINT64},
+        {"executed_shares", 19, 4, UINT32},
+        {"match_number", 23, 8, UINT64},
+        {"printable", 31, 1, UINT8},
+        {"execution_price", 32, 4, UINT32},
+    }));
+    schema.add_message_type('X', with_itch_header({
+        {"order_reference", 11, 8, UINT64},
+        {"cancelled_shares", 19, 4, UINT32},
+    }));
+    schema.add_message_type('D', with_itch_header({{"order_reference", 11, 8, UINT64}}));
+    schema.add_message_type('U', with_itch_header({
+        {"original_order_reference", 11, 8, UINT64},
+        {"new_order_reference", 19, 8, UINT64},
+        {"shares", 27, 4, UINT32},
+        {"price", 31, 4, UINT32},
+    }));
+    schema.add_message_type('P', with_itch_header({
+        {"order_reference", 11, 8, UINT64},
+        {"side", 19, 1, UINT8},
+        {"shares", 20, 4, UINT32},
+        {"stock", 24, 8, CHAR8},
+        {"price", 32, 4, UINT32},
+        {"match_number", 36, 8, UINT64},
+    }));
+
+    return schema;
+}
+
+MappedFileWriter::MappedFileWriter(const char* path)
+    : m_fd(open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) {
+
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to create capture file");
+    }
+}
+
+MappedFileWriter::~MappedFileWriter() {
+    close();
+}
+
+void MappedFileWriter::write_at(size_t offset, const void* data, size_t size) {
+    size_t end = offset + size;
+
+    if (end > m_size) {
+        if (ftruncate(m_fd, static_cast<off_t>(end)) < 0) {
+            throw std::runtime_error("Failed to grow capture file");
+        }
+
+        m_size = end;
+    }
+
+    reserve(end);
+    std::memcpy(m_mapped + offset, data, size);
+}
+
+void MappedFileWriter::sync(size_t offset, size_t size) {
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t start = offset / page_size * page_size; // msync wants a page-aligned address
+
+    if (size > 0 && msync(m_mapped + start, offset + size - start, MS_SYNC) < 0) {
+        throw std::runtime_error("Failed to sync capture file");
+    }
+}
+
+void MappedFileWriter::close() {
+    if (m_mapped) {
+        munmap(m_mapped, m_mapped_size);
+        m_mapped = nullptr;
+        m_mapped_size = 0;
+    }
+
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void MappedFileWriter::reserve(size_t size) {
+    if (size <= m_mapped_size) {
+        return;
+    }
+
+    // Map well past the end of the file so growing it rarely moves the mapping
+    size_t mapped_size = (size + MAPPING_GROWTH - 1) / MAPPING_GROWTH * MAPPING_GROWTH;
+    void* mapped = m_mapped
+        ? mremap(m_mapped, m_mapped_size, mapped_size, MREMAP_MAYMOVE)
+        : mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to map capture file");
+    }
+
+    m_mapped = static_cast<uint8_t*>(mapped);
+    m_mapped_size = mapped_size;
+}
+
+TickCaptureWriter::TickCaptureWriter(TickCaptureConfig config)
+    : m_config(std::move(config))
+    , m_queue(m_config.queue_capacity)
+    , m_file(m_config.path.c_str()) {
+
+    if (m_config.chunk_rows == 0 || m_config.chunk_rows > UINT32_MAX) {
+        throw std::invalid_argument("Chunk rows must be between 1 and 2^32 - 1");
+    }
+
+    for (size_t type = 0; type < m_buffers.size(); type++) {
+        const std::vector<TickFieldSpec>* fields = m_config.schema.get_fields(static_cast<uint8_t>(type));
+
+        if (fields == nullptr) {
+            continue;
+        }
+
+        TypeBuffer& buffer = m_buffers[type];
+        size_t byte_columns = std::count_if(fields->begin(), fields->end(),
+            [](const TickFieldSpec& field) { return field.type == TickColumnType::CHAR8; });
+
+        buffer.fields = fields;
+        buffer.values.resize(1 + fields->size() - byte_columns);
+        buffer.bytes.resize(byte_columns);
+
+        for (const TickFieldSpec& field : *fields) {
+            buffer.min_length = std::max<size_t>(buffer.min_length, field.offset + field.width);
+        }
+    }
+
+    // An empty capture is already a valid file
+    m_file.write_at(0, FILE_MAGIC, sizeof(FILE_MAGIC));
+    m_data_end = sizeof(FILE_MAGIC);
+    write_footer();
+
+    m_thread = std::thread([this] { run(); });
+}
+
+TickCaptureWriter::~TickCaptureWriter() {
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Nothing to report to from a destructor; call close() to see writer errors
+    }
+}
+
+void TickCaptureWriter::close() {
+    if (m_thread.joinable()) {
+        m_running.store(false, std::memory_order_release);
+        m_thread.join();
+        m_file.close();
+    }
+
+    if (m_error) {
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+}
+
+TickCaptureStats TickCaptureWriter::get_stats() const {
+    return {
+        m_captured.load(std::memory_order_relaxed),
+        m_dropped.load(std::memory_order_relaxed),
+        m_oversized.load(std::memory_order_relaxed),
+        m_uncaptured.load(std::memory_order_relaxed),
+        m_chunks_written.load(std::memory_order_relaxed),
+        m_raw_bytes.load(std::memory_order_relaxed),
+        m_file_bytes.load(std::memory_order_relaxed),
+    };
+}
+
+void TickCaptureWriter::run() {
+    try {
+        auto last_flush = std::chrono::steady_clock::now();
+        size_t popped = 0;
+        size_t since_check = 0;
+
+        while (true) {
+            Slot* slot = m_queue.front();
+
+            if (slot != nullptr) {
+                append_row(slot->sequence, reinterpret_cast<const uint8_t*>(slot->data), slot->length);
+                m_queue.pop();
+
+                if (++popped == RELEASE_INTERVAL) {
+                    m_queue.release();
+                    popped = 0;
+                }
+
+                if (++since_check < FLUSH_CHECK_INTERVAL) {
+                    continue;
+                }
+            } else {
+                m_queue.release();
+                popped = 0;
+
+                // Anything published before the stop request is still drained
+                if (!m_running.load(std::memory_order_acquire) && m_queue.front() == nullptr) {
+                    break;
+                }
+            }
+
+            since_check = 0;
+            auto now = std::chrono::steady_clock::now();
+
+            // Rarely seen message types still reach the file within flush_interval
+            if (now - last_flush >= m_config.flush_interval) {
+                flush_all();
+                last_flush = now;
+            }
+
+            if (slot == nullptr) {
+                std::this_thread::sleep_for(IDLE_SLEEP);
+            }
+        }
+
+        flush_all();
+    } catch (...) {
+        m_error = std::current_exception();
+    }
+}
+
+void TickCaptureWriter::append_row(uint64_t sequence, const uint8_t* message, size_t length) {
+    TypeBuffer* buffer = length > 0 ? &m_buffers[message[0]] : nullptr;
+
+    if (buffer == nullptr || buffer->fields == nullptr || length < buffer->min_length) {
+        m_uncaptured.store(m_uncaptured.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (buffer->values[0].capacity() == 0) {
+        for (std::vector<uint64_t>& column : buffer->values) {
+            column.reserve(m_config.chunk_rows);
+        }
+
+        for (std::vector<uint8_t>& column : buffer->bytes) {
+            column.reserve(m_config.chunk_rows * get_column_width(TickColumnType::CHAR8));
+        }
+    }
+
+    buffer->values[0].push_back(sequence);
+    size_t value_column = 1;
+    size_t byte_column = 0;
+
+    for (const TickFieldSpec& field : *buffer->fields) {
+        const uint8_t* data = message + field.offset;
+
+        if (field.type == TickColumnType::CHAR8) {
+            std::vector<uint8_t>& column = buffer->bytes[byte_column++];
+            column.insert(column.end(), data, data + field.width);
+        } else {
+            buffer->values[value_column++].push_back(read_big_endian(data, field.width));
+        }
+    }
+
+    m_captured.store(m_captured.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (++buffer->rows == m_config.chunk_rows) {
+        flush_type(message[0]);
+        write_footer();
+    }
+}
+
+void TickCaptureWriter::flush_type(uint8_t type) {
+    TypeBuffer& buffer = m_buffers[type];
+
+    if (buffer.rows == 0) {
+        return;
+    }
+
+    write_column(type, 0, TickColumnType::UINT64, buffer.values[0]);
+    size_t value_column = 1;
+    size_t byte_column = 0;
+
+    for (size_t i = 0; i < buffer.fields->size(); i++) {
+        const TickFieldSpec& field = (*buffer.fields)[i];
+        uint8_t column = static_cast<uint8_t>(i + 1);
+
+        if (field.type == TickColumnType::CHAR8) {
+            const std::vector<uint8_t>& bytes = buffer.bytes[byte_column++];
+            write_chunk({type, column, TickColumnCodec::RAW, static_cast<uint32_t>(buffer.rows), 0, bytes.size(), 0, 0}, bytes.data());
+            m_raw_bytes.store(m_raw_bytes.load(std::memory_order_relaxed) + bytes.size(), std::memory_order_relaxed);
+        } else {
+            write_column(type, column, field.type, buffer.values[value_column++]);
+        }
+    }
+
+    for (std::vector<uint64_t>& column : buffer.values) {
+        column.clear();
+    }
+
+    for (std::vector<uint8_t>& column : buffer.bytes) {
+        column.clear();
+    }
+
+    buffer.rows = 0;
+    m_chunks_written.store(m_chunks_written.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void TickCaptureWriter::flush_all() {
+    bool flushed = false;
+
+    for (size_t type = 0; type < m_buffers.size(); type++) {
+        if (m_buffers[type].rows > 0) {
+            flush_type(static_cast<uint8_t>(type));
+            flushed = true;
+        }
+    }
+
+    if (flushed) {
+        write_footer();
+    }
+}
+
+void TickCaptureWriter::write_column(uint8_t type, uint8_t column, TickColumnType column_type, const std::vector<uint64_t>& values) {
+    size_t width = get_column_width(column_type);
+    size_t raw_size = values.size() * width;
+    auto [min, max] = std::minmax_element(values.begin(), values.end());
+
+    // Sequence numbers, timestamps and order references mostly step by small amounts
+    m_scratch.clear();
+    uint64_t previous = 0;
+
+    for (uint64_t value : values) {
+        put_varint(m_scratch, zigzag_encode(value - previous));
+        previous = value;
+
+        if (m_scratch.size() >= raw_size) {
+            break;
+        }
+    }
+
+    TickColumnCodec codec = TickColumnCodec::DELTA_VARINT;
+
+    if (m_scratch.size() >= raw_size) {
+        codec = TickColumnCodec::RAW;
+        m_scratch.resize(raw_size);
+
+        for (size_t i = 0; i < values.size(); i++) {
+            std::memcpy(m_scratch.data() + i * width, &values[i], width); // Low bytes, little-endian host
+        }
+    }
+
+    write_chunk({type, column, codec, static_cast<uint32_t>(values.size()), 0, m_scratch.size(), *min, *max}, m_scratch.data());
+    m_raw_bytes.store(m_raw_bytes.load(std::memory_order_relaxed) + raw_size, std::memory_order_relaxed);
+}
+
+void TickCaptureWriter::write_chunk(const ChunkEntry& entry, const uint8_t* data) {
+    constexpr uint8_t PADDING[CHUNK_ALIGNMENT] = {};
+
+    ChunkEntry& written = m_chunks.emplace_back(entry);
+    written.offset = m_data_end;
+    m_file.write_at(m_data_end, data, entry.size);
+    m_data_end += entry.size;
+
+    size_t padding = (CHUNK_ALIGNMENT - m_data_end % CHUNK_ALIGNMENT) % CHUNK_ALIGNMENT;
+    m_file.write_at(m_data_end, PADDING, padding);
+    m_data_end += padding;
+}
+
+void TickCaptureWriter::write_footer() {
+    constexpr uint8_t PADDING[CHUNK_ALIGNMENT] = {};
+
+    m_scratch.clear();
+    put<uint64_t>(m_scratch, m_footer_offset);
+    put<uint64_t>(m_scratch, m_footer_size);
+
+    // The schema never changes, so only the first footer carries it
+    std::vector<uint8_t> types;
+
+    for (size_t type = 0; type < m_buffers.size() && m_footer_offset == 0; type++) {
+        if (m_buffers[type].fields != nullptr) {
+            types.push_back(static_cast<uint8_t>(type));
+        }
+    }
+
+    put<uint32_t>(m_scratch, static_cast<uint32_t>(types.size()));
+
+    for (uint8_t type : types) {
+        const std::vector<TickFieldSpec>& fields = *m_buffers[type].fields;
+
+        put<uint8_t>(m_scratch, type);
+        put<uint8_t>(m_scratch, static_cast<uint8_t>(fields.size() + 1));
+        put<uint8_t>(m_scratch, static_cast<uint8_t>(TickColumnType::UINT64));
+        put<uint8_t>(m_scratch, static_cast<uint8_t>(SEQUENCE_COLUMN.size()));
+        m_scratch.insert(m_scratch.end(), SEQUENCE_COLUMN.begin(), SEQUENCE_COLUMN.end());
+
+        for (const TickFieldSpec& field : fields) {
+            put<uint8_t>(m_scratch, static_cast<uint8_t>(field.type));
+            put<uint8_t>(m_scratch, static_cast<uint8_t>(field.name.size()));
+            m_scratch.insert(m_scratch.end(), field.name.begin(), field.name.end());
+        }
+    }
+
+    put<uint32_t>(m_scratch, static_cast<uint32_t>(m_chunks.size()));
+
+    for (const ChunkEntry& chunk : m_chunks) {
+        put<uint8_t>(m_scratch, chunk.message_type);
+        put<uint8_t>(m_scratch, chunk.column);
+        put<uint8_t>(m_scratch, static_cast<uint8_t>(chunk.codec));
+        put<uint8_t>(m_scratch, 0);
+        put<uint32_t>(m_scratch, chunk.row_count);
+        put<uint64_t>(m_scratch, chunk.offset);
+        put<uint64_t>(m_scratch, chunk.size);
+        put<uint64_t>(m_scratch, chunk.min);
+        put<uint64_t>(m_scratch, chunk.max);
+    }
+
+    // Keeps the trailer, and so the next flush's chunks, aligned
+    size_t padding = (CHUNK_ALIGNMENT - m_scratch.size() % CHUNK_ALIGNMENT) % CHUNK_ALIGNMENT;
+    m_scratch.insert(m_scratch.end(), PADDING, PADDING + padding);
+
+    uint64_t footer_offset = m_data_end;
+    uint64_t footer_size = m_scratch.size();
+    m_file.write_at(footer_offset, m_scratch.data(), footer_size);
+
+    // Only once this flush is on disk may a trailer point at it
+    m_file.sync(m_synced_end, footer_offset + footer_size - m_synced_end);
+
+    m_scratch.clear();
+    put<uint64_t>(m_scratch, footer_offset);
+    put<uint64_t>(m_scratch, footer_size);
+    m_scratch.insert(m_scratch.end(), FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+    m_file.write_at(footer_offset + footer_size, m_scratch.data(), m_scratch.size());
+
+    m_footer_offset = footer_offset;
+    m_footer_size = footer_size;
+    m_data_end = footer_offset + footer_size + TRAILER_SIZE;
+    m_synced_end = footer_offset + footer_size; // The trailer itself is synced with the next flush
+    m_chunks.clear();
+    m_file_bytes.store(m_data_end, std::memory_order_relaxed);
+}
+
+TickCaptureReader::TickCaptureReader(const char* path) {
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open capture file");
+    }
+
+    struct stat st {};
+
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error("Failed to stat capture file");
+    }
+
+    m_mapped_size = static_cast<size_t>(st.st_size);
+
+    if (m_mapped_size < sizeof(FILE_MAGIC) + TRAILER_SIZE) {
+        close(fd);
+        throw std::runtime_error("Not a tick capture file");
+    }
+
+    void* mapped = mmap(nullptr, m_mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after the descriptor is closed
+
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Failed to map capture file");
+    }
+
+    m_mapped = static_cast<const uint8_t*>(mapped);
+
+    try {
+        parse_footers();
+    } catch (...) {
+        munmap(const_cast<uint8_t*>(m_mapped), m_mapped_size);
+        throw;
+    }
+}
+
+TickCaptureReader::~TickCaptureReader() {
+    munmap(const_cast<uint8_t*>(m_mapped), m_mapped_size);
+}
+
+void TickCaptureReader::parse_footers() {
+    if (std::memcmp(m_mapped, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+        throw std::runtime_error("Not a tick capture file");
+    }
+
+    size_t trailer = find_trailer();
+    uint64_t offset;
+    uint64_t size;
+
+    std::memcpy(&offset, m_mapped + trailer, sizeof(offset));
+    std::memcpy(&size, m_mapped + trailer + sizeof(offset), sizeof(size));
+
+    // Footers link newest to oldest; parse them oldest first so chunks stay in write order
+    std::vector<std::pair<uint64_t, uint64_t>> footers;
+
+    while (true) {
+        footers.emplace_back(offset, size);
+
+        FooterCursor cursor(m_mapped + offset, size);
+        uint64_t previous_offset = cursor.get<uint64_t>();
+        uint64_t previous_size = cursor.get<uint64_t>();
+
+        if (previous_offset == 0) {
+            break;
+        }
+
+        if (previous_offset < sizeof(FILE_MAGIC) || previous_offset >= offset
+            || previous_size > offset - previous_offset) {
+            throw std::runtime_error("Corrupt tick capture footer chain");
+        }
+
+        offset = previous_offset;
+        size = previous_size;
+    }
+
+    for (auto footer = footers.rbegin(); footer != footers.rend(); ++footer) {
+        parse_footer(footer->first, footer->second);
+    }
+}
+
+size_t TickCaptureReader::find_trailer() const {
+    size_t position = (m_mapped_size - TRAILER_SIZE) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+
+    // Trailers are aligned: step back over whatever a killed flush left behind the last one
+    while (position >= sizeof(FILE_MAGIC)) {
+        const uint8_t* trailer = m_mapped + position;
+        uint64_t footer_offset;
+        uint64_t footer_size;
+
+        std::memcpy(&footer_offset, trailer, sizeof(footer_offset));
+        std::memcpy(&footer_size, trailer + sizeof(footer_offset), sizeof(footer_size));
+
+        if (std::memcmp(trailer + 2 * sizeof(uint64_t), FILE_MAGIC, sizeof(FILE_MAGIC)) == 0
+            && footer_offset >= sizeof(FILE_MAGIC) && footer_offset <= position
+            && footer_size == position - footer_offset) {
+            return position;
+        }
+
+        position -= CHUNK_ALIGNMENT;
+    }
+
+    throw std::runtime_error("No complete footer in tick capture file");
+}
+
+void TickCaptureReader::parse_footer(uint64_t footer_offset, uint64_t footer_size) {
+    FooterCursor cursor(m_mapped + footer_offset, footer_size);
+    cursor.get<uint64_t>(); // Previous footer, already followed
+    cursor.get<uint64_t>();
+    uint32_t type_count = cursor.get<uint32_t>();
+
+    for (uint32_t i = 0; i < type_count; i++) {
+        uint8_t type = cursor.get<uint8_t>();
+        uint8_t column_count = cursor.get<uint8_t>();
+        std::vector<TickColumnInfo>& columns = m_columns[type];
+
+        columns.clear();
+
+        for (uint8_t column = 0; column < column_count; column++) {
+            uint8_t column_type = cursor.get<uint8_t>();
+            uint8_t name_length = cursor.get<uint8_t>();
+            const char* name = reinterpret_cast<const char*>(cursor.take(name_length));
+
+            if (column_type > static_cast<uint8_t>(TickColumnType::CHAR8)) {
+                throw std::runtime_error("Unknown column type in tick capture footer");
+            }
+
+            columns.push_back({std::string(name, name_length), static_cast<TickColumnType>(column_type)});
+        }
+    }
+
+    uint32_t chunk_count = cursor.get<uint32_t>();
+    m_chunks.reserve(m_chunks.size() + chunk_count);
+
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        uint8_t type = cursor.get<uint8_t>();
+        uint8_t column = cursor.get<uint8_t>();
+        uint8_t codec = cursor.get<uint8_t>();
+        cursor.get<uint8_t>(); // Padding
+        uint32_t row_count = cursor.get<uint32_t>();
+        uint64_t offset = cursor.get<uint64_t>();
+        uint64_t size = cursor.get<uint64_t>();
+        uint64_t min = cursor.get<uint64_t>();
+        uint64_t max = cursor.get<uint64_t>();
+
+        if (column >= m_columns[type].size() || codec > static_cast<uint8_t>(TickColumnCodec::DELTA_VARINT)
+            || offset < sizeof(FILE_MAGIC) || offset > footer_offset || size > footer_offset - offset) {
+            throw std::runtime_error("Corrupt chunk entry in tick capture footer");
+        }
+
+        TickColumnType column_type = m_columns[type][column].type;
+
+        if (codec == static_cast<uint8_t>(TickColumnCodec::RAW) && size != row_count * get_column_width(column_type)) {
+            throw std::runtime_error("Corrupt chunk entry in tick capture footer");
+        }
+
+        m_chunks.push_back({type, column,
+            {column_type, static_cast<TickColumnCodec>(codec), row_count, m_mapped + offset, size, min, max}});
+    }
+}
+
+std::vector<uint8_t> TickCaptureReader::get_message_types() const {
+    std::vector<uint8_t> types;
+
+    for (const ChunkRef& ref : m_chunks) {
+        if (ref.column == 0) {
+            types.push_back(ref.message_type);
+        }
+    }
+
+    std::sort(types.begin(), types.end());
+    types.erase(std::unique(types.begin(), types.end()), types.end());
+
+    return types;
+}
+
+std::vector<TickColumnChunk> TickCaptureReader::get_chunks(uint8_t type, std::string_view column) const {
+    std::vector<TickColumnChunk> chunks;
+    const std::vector<TickColumnInfo>& columns = m_columns[type];
+    auto found = std::find_if(columns.begin(), columns.end(),
+        [column](const TickColumnInfo& info) { return info.name == column; });
+
+    if (found == columns.end()) {
+        return chunks;
+    }
+
+    uint8_t index = static_cast<uint8_t>(found - columns.begin());
+
+    for (const ChunkRef& ref : m_chunks) {
+        if (ref.message_type == type && ref.column == index) {
+            chunks.push_back(ref.chunk);
+        }
+    }
+
+    return chunks;
+}
+
+uint64_t TickCaptureReader::get_row_count(uint8_t type) const {
+    uint64_t rows = 0;
+
+    for (const ChunkRef& ref : m_chunks) {
+        if (ref.message_type == type && ref.column == 0) {
+            rows += ref.chunk.row_count;
+        }
+    }
+
+    return rows;
+}
+
+void decode_tick_column(const TickColumnChunk& chunk, std::vector<uint64_t>& out) {
+    if (chunk.type == TickColumnType::CHAR8) {
+        throw std::invalid_argument("CHAR8 columns are raw bytes, not integers");
+    }
+
+    size_t start = out.size();
+    out.resize(start + chunk.row_count);
+    uint64_t* values = out.data() + start;
+
+    if (chunk.codec == TickColumnCodec::RAW) {
+        size_t width = get_column_width(chunk.type);
+
+        for (size_t i = 0; i < chunk.row_count; i++) {
+            uint64_t value = 0;
+            std::memcpy(&value, chunk.data + i * width, width);
+            values[i] = value;
+        }
+
+        return;
+    }
+
+    const uint8_t* data = chunk.data;
+    const uint8_t* end = chunk.data + chunk.size;
+    uint64_t previous = 0;
+
+    for (size_t i = 0; i < chunk.row_count; i++) {
+        uint64_t encoded = 0;
+        int shift = 0;
+
+        while (true) {
+            if (data == end || shift > 63) {
+                out.resize(start);
+                throw std::runtime_error("Corrupt delta-varint column chunk");
+            }
+
+            uint8_t byte = *data++;
+            encoded |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+
+        previous += zigzag_decode(encoded);
+        values[i] = previous;
+    }
+}
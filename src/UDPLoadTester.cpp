@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <UDPLoadTester.hpp>
+
+namespace {
+
+constexpr int SOCKET_BUFFER_SIZE = 4 * 1024 * 1024;
+constexpr size_t REQUEST_ID_SIZE = sizeof(uint64_t);
+constexpr double PICOSECONDS_PER_SECOND = 1e12;
+
+}
+
+UDPLoadTester::UDPLoadTester(UDPLoadTestConfig config)
+    : m_config(std::move(config))
+    , m_epoll_fd(epoll_create1(0)) {
+
+    if (m_epoll_fd < 0) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+
+    if (m_config.socket_count == 0 || m_config.max_in_flight == 0) {
+        close(m_epoll_fd);
+        throw std::invalid_argument("Load test needs at least one socket and one request in flight");
+    }
+
+    // The schedule is kept in whole picoseconds; a faster rate would round to no interval (closed loop)
+    if (!(m_config.requests_per_second >= 0) || m_config.requests_per_second > PICOSECONDS_PER_SECOND) {
+        close(m_epoll_fd);
+        throw std::invalid_argument("Request rate must be between 0 (closed loop) and 1e12 per second");
+    }
+
+    if (m_config.request_size < REQUEST_ID_SIZE || m_config.request_size > MAX_DATAGRAM_SIZE) {
+        close(m_epoll_fd);
+        throw std::invalid_argument("Request size must be between 8 and 2048 bytes");
+    }
+
+    sockaddr_in server_addr {};
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(m_config.port);
+
+    if (inet_pton(AF_INET, m_config.server_ip.c_str(), &server_addr.sin_addr) <= 0) {
+        close(m_epoll_fd);
+        throw std::runtime_error("Invalid server address");
+    }
+
+    m_sockets.reserve(m_config.socket_count);
+
+    for (size_t i = 0; i < m_config.socket_count; i++) {
+        UDPSocket& socket = m_sockets.emplace_back();
+
+        socket.set_non_blocking(true);
+        socket.set_receive_buffer_size(SOCKET_BUFFER_SIZE);
+        socket.set_send_buffer_size(SOCKET_BUFFER_SIZE);
+        socket.connect(server_addr);
+
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+
+        if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, socket.get_socket_fd(), &event) < 0) {
+            close(m_epoll_fd);
+            throw std::runtime_error("Failed to add socket to epoll");
+        }
+    }
+
+    // Twice the window, so a slot is only reused long after its request was sent
+    m_pending.assign(std::bit_ceil(m_config.max_in_flight) * 2, PendingRequest {});
+    m_pending_mask = m_pending.size() - 1;
+
+    for (size_t i = 0; i < SEND_BATCH_SIZE; i++) {
+        std::fill(m_send_buffers[i].begin(), m_send_buffers[i].end(), static_cast<uint8_t>('x'));
+        m_send_iovecs[i] = {m_send_buffers[i].data(), m_config.request_size};
+        m_send_headers[i].msg_hdr.msg_iov = &m_send_iovecs[i];
+        m_send_headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    for (size_t i = 0; i < RECEIVE_BATCH_SIZE; i++) {
+        m_receive_iovecs[i] = {m_receive_buffers[i].data(), m_receive_buffers[i].size()};
+        m_receive_headers[i].msg_hdr.msg_iov = &m_receive_iovecs[i];
+        m_receive_headers[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+UDPLoadTester::~UDPLoadTester() {
+    close(m_epoll_fd);
+}
+
+UDPLoadTestResults UDPLoadTester::run() {
+    UDPLoadTestResults results;
+    std::array<epoll_event, 64> events;
+
+    m_interval_ps = m_config.requests_per_second > 0
+        ? static_cast<uint64_t>(std::llround(PICOSECONDS_PER_SECOND / m_config.requests_per_second)) : 0;
+    m_start_ns = now_ns();
+
+    uint64_t end_ns = m_start_ns + static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(m_config.duration).count());
+    uint64_t drain_end_ns = end_ns + static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(m_config.timeout).count());
+    uint64_t now = m_start_ns;
+
+    while (true) {
+        now = now_ns();
+
+        if (now < end_ns) {
+            send_due(now, end_ns, results);
+        } else if (m_in_flight == 0 || now >= drain_end_ns) {
+            break;
+        }
+
+        expire(now, results);
+
+        // Sleep until the next request is due, but never past a millisecond so expiry keeps up
+        int wait_ms = 1;
+
+        if (m_interval_ps != 0 && now < end_ns && get_due_time(m_next_id) < now + 1'000'000) {
+            wait_ms = 0;
+        }
+
+        int ready = epoll_wait(m_epoll_fd, events.data(), static_cast<int>(events.size()), wait_ms);
+
+        for (int i = 0; i < ready; i++) {
+            receive_from(m_sockets[events[i].data.u64], results);
+        }
+    }
+
+    // Whatever is still outstanding after the drain period is lost
+    results.timed_out += m_in_flight;
+    m_in_flight = 0;
+    results.elapsed_seconds = static_cast<double>(std::min(now, end_ns) - m_start_ns) / 1e9;
+
+    return results;
+}
+
+uint64_t UDPLoadTester::now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t UDPLoadTester::get_due_time(uint64_t id) const {
+    return m_start_ns + id * m_interval_ps / 1000;
+}
+
+void UDPLoadTester::send_due(uint64_t now, uint64_t end_ns, UDPLoadTestResults& results) {
+    uint64_t due;
+
+    if (m_interval_ps == 0) {
+        due = m_config.max_in_flight - m_in_flight; // Closed loop: refill the window
+    } else {
+        // Open loop: every request scheduled up to now, whether or not the server kept up
+        uint64_t last_due = (std::min(now, end_ns - 1) - m_start_ns) * 1000 / m_interval_ps;
+        due = last_due + 1 > m_next_id ? last_due + 1 - m_next_id : 0;
+    }
+
+    uint64_t room = m_config.max_in_flight - m_in_flight;
+
+    if (due > room) {
+        results.in_flight_stalls++;
+        due = room;
+    }
+
+    while (due > 0) {
+        size_t batch = static_cast<size_t>(std::min<uint64_t>(due, SEND_BATCH_SIZE));
+
+        for (size_t i = 0; i < batch; i++) {
+            uint64_t id = m_next_id + i;
+            std::memcpy(m_send_buffers[i].data(), &id, REQUEST_ID_SIZE);
+        }
+
+        UDPSocket& socket = m_sockets[m_next_socket];
+        m_next_socket = m_next_socket + 1 == m_sockets.size() ? 0 : m_next_socket + 1;
+
+        int sent;
+
+        try {
+            sent = socket.send_many(m_send_headers.data(), static_cast<unsigned int>(batch));
+        } catch (const std::runtime_error&) {
+            results.socket_errors++; // e.g. an ICMP port unreachable from an earlier request
+            sent = 0;
+        }
+
+        for (int i = 0; i < sent; i++) {
+            uint64_t id = m_next_id + static_cast<uint64_t>(i);
+            PendingRequest& slot = m_pending[id & m_pending_mask];
+
+            if (slot.outstanding) {
+                results.timed_out++; // Unanswered for a whole ring of requests
+                m_in_flight--;
+            }
+
+            slot = {id, m_interval_ps == 0 ? now : get_due_time(id), now, true};
+        }
+
+        m_next_id += static_cast<uint64_t>(sent);
+        m_in_flight += static_cast<size_t>(sent);
+        results.sent += static_cast<uint64_t>(sent);
+        due -= static_cast<uint64_t>(sent);
+
+        if (static_cast<size_t>(sent) < batch) {
+            break; // Socket buffer full; the rest stays due and keeps aging
+        }
+    }
+}
+
+void UDPLoadTester::receive_from(UDPSocket& socket, UDPLoadTestResults& results) {
+    while (true) {
+        int received;
+
+        try {
+            received = socket.receive_many(m_receive_headers.data(), RECEIVE_BATCH_SIZE);
+        } catch (const std::runtime_error&) {
+            results.socket_errors++;
+            return;
+        }
+
+        uint64_t now = now_ns();
+
+        for (int i = 0; i < received; i++) {
+            uint64_t id;
+
+            if (m_receive_headers[i].msg_len < REQUEST_ID_SIZE) {
+                results.unmatched++;
+                continue;
+            }
+
+            std::memcpy(&id, m_receive_buffers[i].data(), REQUEST_ID_SIZE);
+            PendingRequest& slot = m_pending[id & m_pending_mask];
+
+            if (!slot.outstanding || slot.id != id) {
+                results.unmatched++;
+                continue;
+            }
+
+            results.response_time.record(now - slot.due_ns);
+            results.service_time.record(now - slot.sent_ns);
+            results.completed++;
+            slot.outstanding = false;
+            m_in_flight--;
+        }
+
+        if (received < static_cast<int>(RECEIVE_BATCH_SIZE)) {
+            return;
+        }
+    }
+}
+
+void UDPLoadTester::expire(uint64_t now, UDPLoadTestResults& results) {
+    uint64_t timeout_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(m_config.timeout).count());
+
+    // Requests are sent in id order, so only the oldest outstanding one can be next to expire
+    while (m_oldest_id < m_next_id) {
+        PendingRequest& slot = m_pending[m_oldest_id & m_pending_mask];
+
+        if (slot.outstanding && slot.id == m_oldest_id) {
+            if (now - slot.sent_ns < timeout_ns) {
+                break;
+            }
+
+            slot.outstanding = false;
+            m_in_flight--;
+            results.timed_out++;
+        }
+
+        m_oldest_id++;
+    }
+}
+
+UDPEchoServer::UDPEchoServer(int port) {
+    m_socket.set_reuse_address(true);
+    m_socket.set_receive_buffer_size(SOCKET_BUFFER_SIZE);
+    m_socket.set_send_buffer_size(SOCKET_BUFFER_SIZE);
+
+    sockaddr_in local_addr {};
+    local_addr.sin_family = AF_INET;
+    local_addr.sin_port = htons(port);
+    local_addr.sin_addr.s_addr = INADDR_ANY;
+
+    m_socket.bind(local_addr);
+
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        m_iovecs[i] = {m_buffers[i].data(), m_buffers[i].size()};
+
+        msghdr& hdr = m_headers[i].msg_hdr;
+        hdr.msg_iov = &m_iovecs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = &m_senders[i];
+        hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+}
+
+void UDPEchoServer::run(const std::atomic<bool>& running) {
+    pollfd ready {m_socket.get_socket_fd(), POLLIN, 0};
+
+    while (running.load(std::memory_order_relaxed)) {
+        if (::poll(&ready, 1, 100) <= 0) {
+            continue;
+        }
+
+        int received = m_socket.receive_many(m_headers.data(), BATCH_SIZE);
+
+        // Send each datagram back as received: same length, to the address it came from
+        for (int i = 0; i < received; i++) {
+            m_iovecs[i].iov_len = m_headers[i].msg_len;
+        }
+
+        int done = 0;
+
+        while (done < received) {
+            try {
+                done += m_socket.send_many(&m_headers[done], static_cast<unsigned int>(received - done));
+            } catch (const std::runtime_error&) {
+                done++; // Drop the one that failed, keep echoing the rest
+            }
+        }
+
+        m_echoed += static_cast<uint64_t>(received);
+
+        for (int i = 0; i < received; i++) {
+            m_iovecs[i].iov_len = m_buffers[i].size();
+            m_headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in); // Value-result, reset for next call
+        }
+    }
+}
@@ -1,4 +1,6 @@
 #include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <stdexcept>
 #include <sys/socket.h>
@@ -37,6 +39,10 @@ UDPSocket& UDPSocket::operator=(UDPSocket&& other) noexcept {
     return *this;
 }
 
+int UDPSocket::get_socket_fd() const {
+    return m_socket_fd;
+}
+
 void UDPSocket::set_reuse_address(bool enable) {
     int reuse = enable ? 1 : 0;
     
@@ -59,6 +65,26 @@ void UDPSocket::set_multicast_loopback(bool enable) {
     }
 }
 
+void UDPSocket::set_non_blocking(bool enable) {
+    int flags = fcntl(m_socket_fd, F_GETFL, 0);
+
+    if (flags < 0 || fcntl(m_socket_fd, F_SETFL, enable ? flags | O_NONBLOCK : flags & ~O_NONBLOCK) < 0) {
+        throw std::runtime_error("Failed to set O_NONBLOCK");
+    }
+}
+
+void UDPSocket::set_receive_buffer_size(int bytes) {
+    if (setsockopt(m_socket_fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) < 0) {
+        throw std::runtime_error("Failed to set SO_RCVBUF");
+    }
+}
+
+void UDPSocket::set_send_buffer_size(int bytes) {
+    if (setsockopt(m_socket_fd, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes)) < 0) {
+        throw std::runtime_error("Failed to set SO_SNDBUF");
+    }
+}
+
 void UDPSocket::join_multicast_group(const char* multicast_addr, const char* interface_addr) {
     ip_mreq mreq {};
     
@@ -85,6 +111,12 @@ void UDPSocket::bind(sockaddr_in& addr) {
     }
 }
 
+void UDPSocket::connect(const sockaddr_in& addr) {
+    if (::connect(m_socket_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+        throw std::runtime_error("Failed to connect UDP socket");
+    }
+}
+
 ssize_t UDPSocket::send_to(const char* data, size_t len, const sockaddr_in& dest_addr) {
     ssize_t bytes_sent = sendto(m_socket_fd, data, len, 0,
         reinterpret_cast<const sockaddr*>(&dest_addr), sizeof(dest_addr));
@@ -102,9 +134,41 @@ ssize_t UDPSocket::receive_from(char* buffer, size_t len, sockaddr_in& src_addr)
     ssize_t bytes_received = recvfrom(m_socket_fd, buffer, len, 0,
         reinterpret_cast<sockaddr*>(&src_addr), &addr_len);
 
+    if (bytes_received < 0 && errno == EINTR) {
+        return -1;
+    }
+
     if (bytes_received < 0) {
         throw std::runtime_error("Failed to receive data");
     }
 
     return bytes_received;
 }
+
+int UDPSocket::receive_many(mmsghdr* msgs, unsigned int vlen) {
+    int messages_received = recvmmsg(m_socket_fd, msgs, vlen, MSG_WAITFORONE, nullptr);
+
+    if (messages_received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return 0;
+    }
+
+    if (messages_received < 0) {
+        throw std::runtime_error("Failed to receive data");
+    }
+
+    return messages_received;
+}
+
+int UDPSocket::send_many(mmsghdr* msgs, unsigned int vlen) {
+    int messages_sent = sendmmsg(m_socket_fd, msgs, vlen, 0);
+
+    if (messages_sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return 0;
+    }
+
+    if (messages_sent < 0) {
+        throw std::runtime_error("Failed to send data");
+    }
+
+    return messages_sent;
+}
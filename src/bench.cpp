@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <HotPathArena.hpp>
+#include <MoldUDPReceiver.hpp>
+#include <ShardedDispatcher.hpp>
+#include <SubscriptionFilter.hpp>
+
+/*
+Throughput benchmark for the MoldUDP64 receive pipeline.
+Packets are synthesised in memory and replayed through ReplayTransport, so only the
+parse/dispatch cost is measured, not the kernel or NIC.
+
+The startup cases run first, each in a freshly forked process, and time the first bursts
+a receiver sees with and without HotPathArena + start().
+*/
+
+constexpr size_t PACKETS_PER_ROUND = 1024;
+constexpr size_t POLLS_PER_ROUND = PACKETS_PER_ROUND / RECEIVE_BATCH_SIZE;
+constexpr size_t ROUNDS = 2000;
+constexpr size_t DISPATCH_ROUNDS = 20;
+constexpr int WORK_PASSES = 2; // Synthetic per-message work for the dispatcher runs
+constexpr size_t ITCH_MESSAGE_SIZE = 36; // Size of an ITCH 5.0 Add Order message
+constexpr uint16_t STOCK_LOCATE_COUNT = 8192;
+constexpr uint16_t SUBSCRIBED_LOCATES = 256;
+constexpr size_t STARTUP_POLLS = 8; // First-N-packet latency covers STARTUP_POLLS bursts
+constexpr size_t STEADY_STATE_POLLS = 4096;
+constexpr size_t STARTUP_RUNS = 7;
+
+// Builds ITCH-shaped messages: type byte followed by a big-endian stock locate
+std::vector<std::vector<uint8_t>> make_packets() {
+    std::vector<std::vector<uint8_t>> packets;
+    MoldUDPPacketBuilder builder("BENCH", 1);
+    std::string message(ITCH_MESSAGE_SIZE, '\0');
+    uint32_t counter = 0;
+
+    while (packets.size() < PACKETS_PER_ROUND) {
+        uint16_t locate = static_cast<uint16_t>((counter * 2654435761u) % STOCK_LOCATE_COUNT + 1);
+        message[0] = "AEXDU"[counter % 5];
+        message[1] = static_cast<char>(locate >> 8);
+        message[2] = static_cast<char>(locate & 0xFF);
+
+        if (!builder.add_message(message)) {
+            auto packet = builder.get_packet();
+            packets.emplace_back(packet.begin(), packet.end());
+            builder.reset(builder.get_next_sequence_number());
+            continue;
+        }
+
+        counter++;
+    }
+
+    return packets;
+}
+
+struct CountingHandler {
+    uint64_t messages {0};
+    uint64_t bytes {0};
+
+    void on_datagram(const sockaddr_in&, size_t) {}
+    void on_packet(const MoldUDP64PacketHeader&) {}
+    void on_message(uint64_t, std::string_view message) {
+        messages++;
+        bytes += message.size();
+    }
+    void on_error(const char*) {}
+};
+
+// Per-message handler that only keeps Add Order ('A') messages
+struct TypeFilterHandler : CountingHandler {
+    void on_message(uint64_t, std::string_view message) {
+        if (!message.empty() && message[0] == 'A') {
+            messages++;
+            bytes += message.size();
+        }
+    }
+};
+
+// Batch handler doing the same selection with the vectorised kernel over the type column
+struct BatchTypeFilterHandler {
+    uint64_t messages {0};
+    uint64_t bytes {0};
+    std::vector<uint32_t> selection;
+
+    void on_batch(const MoldUDPMessageBatch& batch) {
+        selection.resize(batch.size());
+        size_t selected = select_by_type(batch, 'A', selection.data());
+        auto lengths = batch.get_lengths();
+
+        for (size_t i = 0; i < selected; i++) {
+            bytes += lengths[selection[i]];
+        }
+        messages += selected;
+    }
+    void on_error(const char*) {}
+};
+
+// Stands in for full-depth book building: a few passes of FNV-1a over every message
+struct WorkHandler : CountingHandler {
+    void on_message(uint64_t, std::string_view message) {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (int pass = 0; pass < WORK_PASSES; pass++) {
+            for (char c : message) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+            }
+        }
+
+        messages++;
+        bytes += hash & 0xFF;
+    }
+};
+
+// Records when the first real message reached the handler
+struct FirstMessageClock {
+    std::chrono::steady_clock::time_point time {};
+    bool seen {false};
+
+    void mark() {
+        if (!seen) {
+            seen = true;
+            time = std::chrono::steady_clock::now();
+        }
+    }
+};
+
+// Both still do their full work during warm-up, they only keep it off the first-message clock
+struct TimedHandler : CountingHandler {
+    FirstMessageClock first_message;
+    bool warming_up {false};
+
+    void on_message(uint64_t sequence, std::string_view message) {
+        if (!warming_up) {
+            first_message.mark();
+        }
+        CountingHandler::on_message(sequence, message);
+    }
+    void on_warm_up(bool active) { warming_up = active; }
+};
+
+struct TimedBatchHandler : BatchTypeFilterHandler {
+    FirstMessageClock first_message;
+    bool warming_up {false};
+
+    void on_batch(const MoldUDPMessageBatch& batch) {
+        if (!warming_up) {
+            first_message.mark();
+        }
+        BatchTypeFilterHandler::on_batch(batch);
+    }
+    void on_warm_up(bool active) { warming_up = active; }
+};
+
+// Startup timings of one fresh receiver, in nanoseconds
+struct StartupSample {
+    double setup;
+    double first_message;
+    double first_burst; // Per packet
+    double first_packets; // Per packet, over the first STARTUP_POLLS bursts
+    double steady_state; // Per packet
+};
+
+template <typename Handler>
+StartupSample run_startup(bool prepared) {
+    using Clock = std::chrono::steady_clock;
+    auto ns = [](Clock::duration d) { return std::chrono::duration<double, std::nano>(d).count(); };
+    std::vector<Clock::duration> polls(STARTUP_POLLS);
+
+    // Pre-faulting the arena sweeps the caches, so the packets are only built after it
+    auto arena_start = Clock::now();
+    std::unique_ptr<HotPathArena> arena = prepared ? std::make_unique<HotPathArena>() : nullptr;
+    std::pmr::memory_resource* memory = arena ? arena.get() : std::pmr::get_default_resource();
+    auto setup = Clock::now() - arena_start;
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, Handler> receiver {ReplayTransport(make_packets()), {}, {}, memory};
+
+    if (prepared) {
+        auto start = Clock::now();
+        receiver.start();
+        setup += Clock::now() - start;
+    }
+
+    auto first_poll = Clock::now();
+
+    for (size_t i = 0; i < STARTUP_POLLS; i++) {
+        auto poll_start = Clock::now();
+        receiver.receive_and_process();
+        polls[i] = Clock::now() - poll_start;
+    }
+
+    auto steady_start = Clock::now();
+
+    for (size_t i = 0; i < STEADY_STATE_POLLS; i++) {
+        receiver.receive_and_process();
+    }
+
+    auto steady = Clock::now() - steady_start;
+    double first_packets = 0;
+
+    for (Clock::duration poll : polls) {
+        first_packets += ns(poll);
+    }
+
+    return {
+        ns(setup),
+        ns(receiver.get_handler().first_message.time - first_poll),
+        ns(polls[0]) / RECEIVE_BATCH_SIZE,
+        first_packets / (STARTUP_POLLS * RECEIVE_BATCH_SIZE),
+        ns(steady) / (STEADY_STATE_POLLS * RECEIVE_BATCH_SIZE),
+    };
+}
+
+/*
+Time-to-first-message and first-N-packet latency of a receiver that has just been created.
+Each run is a forked child, so that every one starts from the same cold process state;
+the medians over STARTUP_RUNS runs are printed.
+*/
+template <typename Handler>
+void measure_startup(std::string_view name, bool prepared) {
+    std::vector<StartupSample> samples;
+
+    for (size_t run = 0; run < STARTUP_RUNS; run++) {
+        int fds[2];
+
+        if (pipe(fds) != 0) {
+            throw std::runtime_error("Failed to create pipe for startup benchmark");
+        }
+
+        std::cout.flush();
+        pid_t pid = fork();
+
+        if (pid < 0) {
+            throw std::runtime_error("Failed to fork startup benchmark");
+        }
+
+        if (pid == 0) {
+            StartupSample sample = run_startup<Handler>(prepared);
+            ssize_t written = write(fds[1], &sample, sizeof(sample));
+            _exit(written == sizeof(sample) ? 0 : 1);
+        }
+
+        close(fds[1]);
+        StartupSample sample;
+
+        if (read(fds[0], &sample, sizeof(sample)) == sizeof(sample)) {
+            samples.push_back(sample);
+        }
+
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+    }
+
+    if (samples.empty()) {
+        throw std::runtime_error("Startup benchmark produced no samples");
+    }
+
+    auto median = [&](double StartupSample::*field) {
+        std::vector<double> values;
+        for (const StartupSample& sample : samples) {
+            values.push_back(sample.*field);
+        }
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+
+    std::cout << std::left << std::setw(30) << name << std::right << std::fixed << std::setprecision(1)
+              << "setup " << std::setw(6) << median(&StartupSample::setup) / 1e6 << " ms"
+              << "   first msg " << std::setw(6) << median(&StartupSample::first_message) / 1e3 << " us"
+              << "   first burst " << std::setw(6) << median(&StartupSample::first_burst) << " ns/pkt"
+              << "   first " << STARTUP_POLLS * RECEIVE_BATCH_SIZE << " " << std::setw(6)
+              << median(&StartupSample::first_packets) << " ns/pkt"
+              << "   steady " << std::setw(6) << median(&StartupSample::steady_state) << " ns/pkt\n";
+}
+
+template <typename Fn>
+void measure(std::string_view name, Fn&& run_round, size_t rounds = ROUNDS) {
+    run_round(); // Warm caches before timing
+
+    uint64_t messages = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t round = 0; round < rounds; round++) {
+        messages += run_round();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << (messages / elapsed / 1e6) << " Mmsg/s"
+              << std::setw(10) << (elapsed * 1e9 / messages) << " ns/msg\n";
+}
+
+// The original hand-written loop, kept as the reference the templated receiver must match
+uint64_t hand_written_round(const std::vector<std::vector<uint8_t>>& packets, CountingHandler& handler) {
+    uint64_t before = handler.messages;
+
+    for (const std::vector<uint8_t>& packet : packets) {
+        const uint8_t* payload = packet.data();
+        size_t length = packet.size();
+
+        if (length < sizeof(MoldUDP64PacketHeader)) {
+            continue;
+        }
+
+        const MoldUDP64PacketHeader* header = reinterpret_cast<const MoldUDP64PacketHeader*>(payload);
+        size_t offset = sizeof(MoldUDP64PacketHeader);
+        uint16_t msg_count = header->get_message_count();
+
+        for (int i = 0; i < msg_count; i++) {
+            if (offset + sizeof(MoldUDP64MessageHeader) > length) {
+                break;
+            }
+
+            const MoldUDP64MessageHeader* msg_header =
+                reinterpret_cast<const MoldUDP64MessageHeader*>(payload + offset);
+            offset += sizeof(MoldUDP64MessageHeader);
+
+            uint16_t msg_len = msg_header->get_message_length();
+
+            if (offset + msg_len > length) {
+                break;
+            }
+
+            handler.on_message(0, std::string_view(reinterpret_cast<const char*>(payload + offset), msg_len));
+            offset += msg_len;
+        }
+    }
+
+    return handler.messages - before;
+}
+
+int main() {
+    // Before anything else warms this process up
+    std::cout << "Receiver startup (median of " << STARTUP_RUNS << " fresh processes per case)\n\n";
+    measure_startup<TimedHandler>("per message, cold", false);
+    measure_startup<TimedHandler>("per message, arena + warm-up", true);
+    measure_startup<TimedBatchHandler>("SoA batch, cold", false);
+    measure_startup<TimedBatchHandler>("SoA batch, arena + warm-up", true);
+
+    std::vector<std::vector<uint8_t>> packets = make_packets();
+
+    std::cout << "\nMoldUDP64 pipeline benchmark: " << PACKETS_PER_ROUND << " packets x "
+              << ROUNDS << " rounds\n\n";
+
+    CountingHandler reference;
+    measure("hand-written parse loop", [&] {
+        return hand_written_round(packets, reference);
+    });
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, CountingHandler> receiver {ReplayTransport(packets)};
+    measure("MoldUDPReceiver<Replay>", [&] {
+        uint64_t before = receiver.get_handler().messages;
+        for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+            receiver.receive_and_process();
+        }
+        return receiver.get_handler().messages - before;
+    });
+
+    // Throughput below is counted in messages parsed, not messages selected
+    uint64_t messages_per_round = receiver.get_handler().messages / (ROUNDS + 1);
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, TypeFilterHandler> filtered {ReplayTransport(packets)};
+    measure("type filter, per message", [&] {
+        for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+            filtered.receive_and_process();
+        }
+        return messages_per_round;
+    });
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, BatchTypeFilterHandler> batched {ReplayTransport(packets)};
+    measure("type filter, SoA batch (exp.)", [&] {
+        for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+            batched.receive_and_process();
+        }
+        return messages_per_round;
+    });
+
+    // Subscribe to every 32nd stock locate
+    SubscriptionFilter subscriptions;
+    for (uint16_t locate = 1; locate <= STOCK_LOCATE_COUNT; locate += STOCK_LOCATE_COUNT / SUBSCRIBED_LOCATES) {
+        subscriptions.subscribe(locate);
+    }
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, SubscribedHandler<CountingHandler>> subscribed {
+        ReplayTransport(packets), {}, SubscribedHandler<CountingHandler>(subscriptions)};
+    measure("subscription filter, per message", [&] {
+        for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+            subscribed.receive_and_process();
+        }
+        return messages_per_round;
+    });
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, SubscribedBatchHandler<CountingHandler>> subscribed_batch {
+        ReplayTransport(packets), {}, SubscribedBatchHandler<CountingHandler>(subscriptions)};
+    measure("subscription filter, batch (exp.)", [&] {
+        for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+            subscribed_batch.receive_and_process();
+        }
+        return messages_per_round;
+    });
+
+    std::cout << "(" << SUBSCRIBED_LOCATES << " of " << STOCK_LOCATE_COUNT << " stock locates subscribed, "
+              << subscribed_batch.get_handler().get_inner().messages * 100.0 / ((ROUNDS + 1) * messages_per_round)
+              << "% of messages delivered)\n";
+
+    // Sharded dispatch: compare inline processing with N worker threads doing the same work
+    std::cout << "\n";
+
+    MoldUDPReceiver<ReplayTransport, NullSequencer, WorkHandler> inline_work {ReplayTransport(packets)};
+    measure("work inline, 1 thread", [&] {
+        for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+            inline_work.receive_and_process();
+        }
+        return messages_per_round;
+    }, DISPATCH_ROUNDS);
+
+    unsigned cores = std::thread::hardware_concurrency(); // 0 when unknown
+    size_t max_workers = cores > 1 ? cores - 1 : 1; // Leave a core for the receive thread
+
+    for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+        using Dispatcher = ShardedDispatcher<WorkHandler>;
+        ShardedDispatcherConfig config;
+        config.worker_count = workers;
+
+        Dispatcher dispatcher(config, [](size_t) { return WorkHandler {}; });
+        MoldUDPReceiver<ReplayTransport, NullSequencer, DispatchingBatchHandler<Dispatcher>> sharded {
+            ReplayTransport(packets), {}, DispatchingBatchHandler<Dispatcher>(dispatcher)};
+
+        measure("work sharded, " + std::to_string(workers) + " worker(s)", [&] {
+            for (size_t i = 0; i < POLLS_PER_ROUND; i++) {
+                sharded.receive_and_process();
+            }
+            dispatcher.wait_until_drained();
+            return messages_per_round;
+        }, DISPATCH_ROUNDS);
+
+        for (size_t i = 0; i < workers; i++) {
+            ShardedDispatcherWorkerMetrics metrics = dispatcher.get_worker_metrics(i);
+            std::cout << "    worker " << i << ": " << metrics.processed << " msgs, max lag "
+                      << metrics.max_lag_ns / 1000 << " us, " << metrics.producer_stalls << " stalls\n";
+        }
+    }
+
+    // Print the checksums so the compiler cannot discard the work
+    std::cout << "\nchecksum: " << reference.bytes << " / " << receiver.get_handler().bytes
+              << " / " << filtered.get_handler().bytes << " / " << batched.get_handler().bytes
+              << " / " << subscribed.get_handler().get_inner().bytes
+              << " / " << subscribed_batch.get_handler().get_inner().bytes << "\n";
+
+    return 0;
+}
@@ -1,17 +1,126 @@
+#include <csignal>
 #include <iostream>
+#include <optional>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <HotPathArena.hpp>
 #include <MoldUDPReceiver.hpp>
+#include <TickCapture.hpp>
 
 constexpr int MULTICAST_PORT = 9000;
 constexpr std::string_view MULTICAST_GROUP = "239.1.1.1";
 
-int main() {
-    MoldUDPReceiver receiver(MULTICAST_GROUP.data(), MULTICAST_PORT);
-    
+volatile std::sig_atomic_t keep_running = 1;
+
+void signal_handler(int) {
+    keep_running = 0;
+}
+
+// Without SA_RESTART, so a blocked receive returns and the loop sees keep_running
+void install_signal_handlers() {
+    struct sigaction action {};
+    action.sa_handler = signal_handler;
+    sigemptyset(&action.sa_mask);
+
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+}
+
+template <typename Transport, typename Handler = PrintingHandler>
+void run(Transport transport, HotPathArena& arena, Handler handler = {}) {
+    MoldUDPReceiver<Transport, NullSequencer, Handler> receiver(std::move(transport), {}, std::move(handler), &arena);
+
+    receiver.start(); // Warm up, then join the group
+
+    std::cout << "Hot path arena: " << arena.get_used() << " of " << arena.get_capacity() << " bytes used, "
+              << (arena.is_huge_page_backed() ? "hugepages" : "regular pages")
+              << (arena.is_locked() ? ", locked" : ", not locked") << "\n";
     std::cout << "\nWaiting for MoldUDP packets... (Ctrl+C to exit)\n";
-    
-    while (true) {
+
+    while (keep_running) {
         receiver.receive_and_process();
+
+#ifdef MOLD_UDP_HAS_PCAP
+        if constexpr (std::is_same_v<Transport, PcapTransport>) {
+            if (receiver.get_transport().is_exhausted()) {
+                break;
+            }
+        }
+#endif
+    }
+}
+
+// Prints messages, or writes them to a capture file when one is given
+template <typename Transport>
+void run_with_output(Transport transport, HotPathArena& arena, std::optional<TickCaptureWriter>& capture) {
+    if (!capture) {
+        run(std::move(transport), arena);
+        return;
+    }
+
+    run(std::move(transport), arena, TickCaptureHandler(*capture));
+
+    // Reached on Ctrl+C / SIGTERM too: drain the queue, flush partial chunks, write the footer
+    capture->close();
+
+    TickCaptureStats stats = capture->get_stats();
+    std::cout << "Captured " << stats.captured << " messages (" << stats.uncaptured << " of other types, "
+              << stats.dropped << " dropped) into " << stats.file_bytes << " bytes, "
+              << stats.raw_bytes << " bytes of column data before encoding\n";
+}
+
+/*
+Usage: mold_udp_client [socket | recvmmsg | io_uring | pcap <file-or-device>] [--capture <file>]
+Defaults to one recvfrom per packet (socket). With --capture, messages are written to a
+columnar tick capture instead of printed.
+*/
+int main(int argc, char** argv) {
+    std::vector<std::string_view> args;
+    const char* capture_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::string_view(argv[i]) == "--capture" && i + 1 < argc) {
+            capture_path = argv[++i];
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    std::string_view transport = !args.empty() ? args[0] : "socket";
+
+    install_signal_handlers();
+
+    try {
+        HotPathArena arena;
+        std::optional<TickCaptureWriter> capture;
+
+        if (capture_path) {
+            TickCaptureConfig config;
+            config.path = capture_path;
+            capture.emplace(std::move(config));
+        }
+
+        if (transport == "socket") {
+            run_with_output(SocketTransport(MULTICAST_GROUP.data(), MULTICAST_PORT, nullptr, &arena), arena, capture);
+        } else if (transport == "recvmmsg") {
+            run_with_output(RecvmmsgTransport(MULTICAST_GROUP.data(), MULTICAST_PORT, nullptr, &arena), arena, capture);
+#ifdef MOLD_UDP_HAS_IO_URING
+        } else if (transport == "io_uring") {
+            run_with_output(IoUringTransport(MULTICAST_GROUP.data(), MULTICAST_PORT, nullptr, &arena), arena, capture);
+#endif
+#ifdef MOLD_UDP_HAS_PCAP
+        } else if (transport == "pcap" && args.size() > 1) {
+            run_with_output(PcapTransport(args[1].data(), MULTICAST_GROUP.data(), MULTICAST_PORT), arena, capture);
+#endif
+        } else {
+            std::cerr << "Unknown or unavailable transport: " << transport << "\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
     }
 
     return 0;
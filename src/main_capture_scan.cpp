@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <TickCapture.hpp>
+
+namespace {
+
+// Message types, row counts and the stored size of every column
+void list_capture(const TickCaptureReader& reader) {
+    for (uint8_t type : reader.get_message_types()) {
+        std::cout << "'" << type << "': " << reader.get_row_count(type) << " rows\n";
+
+        for (const TickColumnInfo& column : reader.get_columns(type)) {
+            size_t bytes = 0;
+            size_t delta_chunks = 0;
+            std::vector<TickColumnChunk> chunks = reader.get_chunks(type, column.name);
+
+            for (const TickColumnChunk& chunk : chunks) {
+                bytes += chunk.size;
+                delta_chunks += chunk.codec == TickColumnCodec::DELTA_VARINT;
+            }
+
+            std::cout << "  " << column.name << ": " << bytes << " bytes in " << chunks.size() << " chunks ("
+                      << delta_chunks << " delta-varint)\n";
+        }
+    }
+}
+
+// Decodes one integer column chunk by chunk and prints summary statistics
+void scan_column(const TickCaptureReader& reader, uint8_t type, std::string_view name) {
+    std::vector<TickColumnChunk> chunks = reader.get_chunks(type, name);
+
+    if (chunks.empty()) {
+        throw std::invalid_argument("No such column in capture");
+    }
+
+    std::vector<uint64_t> values;
+    uint64_t count = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const TickColumnChunk& chunk : chunks) {
+        values.clear();
+        decode_tick_column(chunk, values);
+
+        for (uint64_t value : values) {
+            min = std::min(min, value);
+            max = std::max(max, value);
+            sum += static_cast<double>(value);
+        }
+
+        count += values.size();
+    }
+
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "'" << type << "' " << name << ": " << count << " values, min " << (count ? min : 0) << ", max " << max
+              << ", mean " << (count ? sum / static_cast<double>(count) : 0.0) << "\n";
+    std::cout << "Scanned in " << elapsed_ns / 1e6 << " ms (" << (count ? elapsed_ns / static_cast<double>(count) : 0.0)
+              << " ns/value)\n";
+}
+
+}
+
+/*
+Usage: mold_udp_capture_scan <capture-file> [<message-type> <column>]
+
+Without a column, lists the message types and columns in a tick capture written by
+mold_udp_client --capture. With one, decodes only that column and prints its count,
+min, max and mean, e.g. mold_udp_capture_scan ticks.cap A price.
+*/
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <capture-file> [<message-type> <column>]\n";
+        return 1;
+    }
+
+    try {
+        TickCaptureReader reader(argv[1]);
+
+        if (argc == 2) {
+            list_capture(reader);
+        } else {
+            scan_column(reader, static_cast<uint8_t>(argv[2][0]), argv[3]);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string_view>
 #include <csignal>
+#include <HotPathArena.hpp>
 #include <MoldUDPReceiverDPDK.hpp>
 
 constexpr int MULTICAST_PORT = 9000;
@@ -28,9 +29,13 @@ int main(int argc, char** argv) {
         */
         
         std::cout << "Initializing DPDK...\n";
-        MoldUDPReceiverDPDK::init_dpdk(argc, argv);
+        DPDKTransport::init_dpdk(argc, argv);
         
-        MoldUDPReceiverDPDK receiver(MULTICAST_GROUP.data(), MULTICAST_PORT);
+        // Batch columns come from a locked, pre-faulted arena; mbufs already live in DPDK hugepages
+        HotPathArena arena;
+        MoldUDPReceiverDPDK receiver(DPDKTransport(MULTICAST_GROUP.data(), MULTICAST_PORT), {}, {}, &arena);
+
+        receiver.start(); // Warm up, then start the port
         
         std::cout << "\nWaiting for MoldUDP packets... (Ctrl+C to exit)\n";
         std::cout << "Zero-copy processing enabled via DPDK\n\n";
@@ -1,15 +1,22 @@
 #include <arpa/inet.h>
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <netinet/in.h>
+#include <string>
 #include <string_view>
 #include <sys/socket.h>
+#include <thread>
 #include <unistd.h>
+#include <UDPLoadTester.hpp>
 
 constexpr int PORT = 8080;
 constexpr int BUFFER_SIZE = 1024;
 constexpr std::string_view SERVER_IP = "127.0.0.1";
 
-int main() {
+// The original client: one request at a time, typed on stdin
+int run_interactive() {
     int socket_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 
     if (socket_fd < 0) {
@@ -79,4 +86,143 @@ int main() {
 
     close(socket_fd);
     return 0;
-};
+}
+
+void print_results(const UDPLoadTestConfig& config, const UDPLoadTestResults& results) {
+    double rate = results.elapsed_seconds > 0 ? static_cast<double>(results.sent) / results.elapsed_seconds : 0.0;
+
+    std::cout << "\nSent " << results.sent << " requests in " << results.elapsed_seconds << " s ("
+              << rate << " req/s)\n";
+    std::cout << "Completed: " << results.completed << ", timed out: " << results.timed_out
+              << ", unmatched: " << results.unmatched << ", socket errors: " << results.socket_errors << "\n";
+
+    if (results.in_flight_stalls) {
+        std::cout << "Held back " << results.in_flight_stalls << " times at " << config.max_in_flight
+                  << " requests in flight\n";
+    }
+
+    if (config.requests_per_second > 0) {
+        std::cout << "\nResponse time (from scheduled send, " << config.requests_per_second << " req/s):\n";
+        results.response_time.print_percentiles(std::cout);
+    }
+
+    std::cout << "\nService time (from actual send):\n";
+    results.service_time.print_percentiles(std::cout);
+}
+
+/*
+Open-loop load test against the UDP server (or a local echo server with --local-echo).
+Options: --server IP --port N --rate REQ_PER_S (0 = closed loop) --sockets N
+         --in-flight N --duration-ms N --timeout-ms N --size BYTES --local-echo
+*/
+int run_load_test(int argc, char** argv) {
+    UDPLoadTestConfig config;
+    config.server_ip = std::string(SERVER_IP);
+    config.port = PORT;
+    bool local_echo = false;
+
+    for (int i = 2; i < argc; i++) {
+        std::string_view option = argv[i];
+
+        if (option == "--local-echo") {
+            local_echo = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << "\n";
+            return 1;
+        }
+
+        const char* value = argv[++i];
+
+        if (option == "--server") {
+            config.server_ip = value;
+        } else if (option == "--port") {
+            config.port = std::atoi(value);
+        } else if (option == "--rate") {
+            config.requests_per_second = std::strtod(value, nullptr);
+        } else if (option == "--sockets") {
+            config.socket_count = std::strtoull(value, nullptr, 10);
+        } else if (option == "--in-flight") {
+            config.max_in_flight = std::strtoull(value, nullptr, 10);
+        } else if (option == "--duration-ms") {
+            config.duration = std::chrono::milliseconds(std::strtoll(value, nullptr, 10));
+        } else if (option == "--timeout-ms") {
+            config.timeout = std::chrono::milliseconds(std::strtoll(value, nullptr, 10));
+        } else if (option == "--size") {
+            config.request_size = std::strtoull(value, nullptr, 10);
+        } else {
+            std::cerr << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+
+    // Bad options throw here, before there is an echo thread to clean up
+    UDPLoadTester tester(config);
+    std::unique_ptr<UDPEchoServer> echo_server;
+
+    if (local_echo) {
+        echo_server = std::make_unique<UDPEchoServer>(config.port);
+    }
+
+    // Stops and joins the echo thread on every way out, including a throwing run()
+    struct EchoThread {
+        std::atomic<bool> running {true};
+        std::thread thread;
+
+        ~EchoThread() {
+            running = false;
+
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    } echo;
+
+    if (echo_server) {
+        echo.thread = std::thread([&] { echo_server->run(echo.running); });
+    }
+
+    std::cout << "UDP load test against " << config.server_ip << ":" << config.port
+              << (local_echo ? " (local echo server)" : "") << "\n";
+    std::cout << config.socket_count << " sockets, up to " << config.max_in_flight << " requests in flight, "
+              << config.request_size << "-byte requests, "
+              << (config.requests_per_second > 0 ? std::to_string(static_cast<uint64_t>(config.requests_per_second)) + " req/s open loop"
+                                                 : std::string("closed loop"))
+              << ", " << config.duration.count() << " ms\n";
+
+    UDPLoadTestResults results = tester.run();
+
+    print_results(config, results);
+    return 0;
+}
+
+/*
+Usage: simple_client                     interactive client
+       simple_client load [options]      pipelined load test, see run_load_test()
+       simple_client echo [port]         stand-in echo server for the load test
+*/
+int main(int argc, char** argv) {
+    std::string_view mode = argc > 1 ? argv[1] : "";
+
+    try {
+        if (mode == "load") {
+            return run_load_test(argc, argv);
+        }
+
+        if (mode == "echo") {
+            UDPEchoServer server(argc > 2 ? std::atoi(argv[2]) : PORT);
+            std::atomic<bool> running {true};
+
+            std::cout << "UDP echo server listening on port " << (argc > 2 ? std::atoi(argv[2]) : PORT) << "\n";
+            server.run(running);
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return run_interactive();
+}
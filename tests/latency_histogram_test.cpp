@@ -0,0 +1,50 @@
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <LatencyHistogram.hpp>
+
+/*
+Checks LatencyHistogram percentiles against exact ranks: values below 2048 ns must come back
+exactly, larger ones within the 3 significant digits, and values at and past
+highest_trackable must stay in range.
+*/
+int main() {
+    constexpr uint64_t VALUE_COUNT = 200'000;
+    constexpr double PERCENTILES[] = {0.1, 0.5, 1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0};
+    constexpr uint64_t HIGHEST = 60'000'000'000;
+
+    LatencyHistogram uniform;
+    bool ok = true;
+
+    for (uint64_t value = 1; value <= VALUE_COUNT; value++) {
+        uniform.record(value);
+    }
+
+    for (double percentile : PERCENTILES) {
+        uint64_t exact = static_cast<uint64_t>(std::ceil(percentile / 100.0 * VALUE_COUNT));
+        uint64_t reported = uniform.get_value_at_percentile(percentile);
+        uint64_t tolerance = exact < 2048 ? 0 : exact / 1000;
+
+        if (reported < exact || reported - exact > tolerance) {
+            std::cerr << "FAIL: p" << percentile << " is " << reported << ", expected " << exact << "\n";
+            ok = false;
+        }
+    }
+
+    LatencyHistogram near_max(HIGHEST);
+    near_max.record(HIGHEST - 1);
+    near_max.record(HIGHEST);
+    near_max.record(2 * HIGHEST); // Clamped
+
+    uint64_t lowest = near_max.get_value_at_percentile(1.0);
+
+    if (lowest < HIGHEST - 1 || lowest - (HIGHEST - 1) > HIGHEST / 1000
+        || near_max.get_value_at_percentile(100.0) != HIGHEST || near_max.get_saturated_count() != 1) {
+        std::cerr << "FAIL: near highest_trackable: p1 " << lowest << ", max "
+                  << near_max.get_value_at_percentile(100.0) << ", saturated " << near_max.get_saturated_count() << "\n";
+        ok = false;
+    }
+
+    std::cout << "LatencyHistogram percentiles: " << (ok ? "ok" : "WRONG") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include <ShardedDispatcher.hpp>
+
+/*
+Per-instrument ordering across rebalancing: a few hot keys that all start on one worker are
+fed through a dispatcher that rebalances every few hundred messages, so they keep moving.
+Each message carries its key's own sequence number, and the handlers check that every key's
+sequence numbers arrive strictly increasing on each worker and without gaps overall.
+*/
+
+constexpr size_t WORKER_COUNT = 4;
+constexpr uint32_t KEY_COUNT = 16;
+constexpr size_t MESSAGE_COUNT = 200000;
+constexpr size_t PHASE_LENGTH = 20000; // Messages before the hot keys change
+constexpr size_t BURST_SIZE = 32;
+
+struct OrderCheckingHandler {
+    std::vector<uint64_t>* last_overall; // Shared by every worker: the dispatcher's fences make that safe
+    std::vector<uint64_t> last_here = std::vector<uint64_t>(KEY_COUNT, 0);
+    uint64_t messages {0};
+    uint64_t out_of_order {0};
+    uint64_t gaps {0};
+
+    void on_datagram(const sockaddr_in&, size_t) {}
+    void on_packet(const MoldUDP64PacketHeader&) {}
+    void on_error(const char*) {}
+
+    void on_message(uint64_t, std::string_view message) {
+        uint32_t key;
+        uint64_t key_sequence;
+        std::memcpy(&key, message.data(), sizeof(key));
+        std::memcpy(&key_sequence, message.data() + sizeof(key), sizeof(key_sequence));
+
+        out_of_order += key_sequence <= last_here[key];
+        gaps += key_sequence != (*last_overall)[key] + 1;
+        last_here[key] = key_sequence;
+        (*last_overall)[key] = key_sequence;
+        messages++;
+    }
+};
+
+int main() {
+    std::vector<uint64_t> last_overall(KEY_COUNT, 0);
+    std::vector<uint64_t> next_sequence(KEY_COUNT, 1);
+
+    ShardedDispatcherConfig config;
+    config.worker_count = WORKER_COUNT;
+    config.queue_capacity = 4096;
+    config.key_space = KEY_COUNT;
+    config.rebalance_interval = 512;
+    config.rebalance_threshold = 1.2;
+
+    ShardedDispatcher<OrderCheckingHandler> dispatcher(config, [&](size_t) {
+        return OrderCheckingHandler {&last_overall};
+    });
+
+    // Fixed LCG, so every run dispatches the same messages
+    uint32_t state = 12345;
+    char message[sizeof(uint32_t) + sizeof(uint64_t)];
+
+    for (size_t i = 0; i < MESSAGE_COUNT; i++) {
+        if (i % BURST_SIZE == 0) {
+            dispatcher.begin_burst();
+        }
+
+        state = state * 1664525u + 1013904223u;
+        uint32_t phase = static_cast<uint32_t>(i / PHASE_LENGTH);
+
+        // Three in four messages go to three keys that share a worker under the initial routing
+        uint32_t key = (state >> 8) % 4 != 0 ? (phase + WORKER_COUNT * ((state >> 16) % 3)) % KEY_COUNT
+                                             : (state >> 16) % KEY_COUNT;
+        uint64_t key_sequence = next_sequence[key]++;
+
+        std::memcpy(message, &key, sizeof(key));
+        std::memcpy(message + sizeof(key), &key_sequence, sizeof(key_sequence));
+        dispatcher.dispatch(i, key, std::string_view(message, sizeof(message)));
+
+        if (i % BURST_SIZE == BURST_SIZE - 1) {
+            dispatcher.publish();
+        }
+    }
+
+    dispatcher.stop();
+
+    uint64_t messages = 0;
+    uint64_t out_of_order = 0;
+    uint64_t gaps = 0;
+
+    for (size_t i = 0; i < WORKER_COUNT; i++) {
+        const OrderCheckingHandler& handler = dispatcher.get_worker_handler(i);
+        messages += handler.messages;
+        out_of_order += handler.out_of_order;
+        gaps += handler.gaps;
+    }
+
+    std::cout << messages << " messages, " << dispatcher.get_migration_count() << " migrations, "
+              << out_of_order << " out of order, " << gaps << " gaps\n";
+
+    if (messages != MESSAGE_COUNT || out_of_order != 0 || gaps != 0) {
+        std::cerr << "FAIL: per-key order was not preserved\n";
+        return 1;
+    }
+
+    if (dispatcher.get_migration_count() == 0) {
+        std::cerr << "FAIL: no key was moved, so ordering across moves was not exercised\n";
+        return 1;
+    }
+
+    return 0;
+}
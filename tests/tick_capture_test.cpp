@@ -0,0 +1,161 @@
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <TickCapture.hpp>
+
+/*
+Round trips through TickCaptureWriter and TickCaptureReader: rows written and closed come
+back column by column; a capture cut short mid-flush, or whose writer was SIGKILLed while
+flushing every millisecond, still opens and holds a gap-free prefix of what was written.
+*/
+
+constexpr size_t ADD_ORDER_LENGTH = 36;
+constexpr size_t ROW_COUNT = 100000;
+
+void put_big_endian(char* out, uint64_t value, size_t width) {
+    for (size_t i = 0; i < width; i++) {
+        out[width - 1 - i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+uint32_t price_of(uint64_t sequence) {
+    return static_cast<uint32_t>(sequence * 7 % 1000000);
+}
+
+// ITCH 5.0 add order whose fields are all derived from its sequence number
+std::string make_add_order(uint64_t sequence) {
+    std::string message(ADD_ORDER_LENGTH, '\0');
+    message[0] = 'A';
+    put_big_endian(&message[1], sequence % 8192, 2); // Stock locate
+    put_big_endian(&message[5], sequence * 1000, 6); // Timestamp
+    put_big_endian(&message[11], sequence, 8); // Order reference
+    message[19] = 'B';
+    put_big_endian(&message[20], 100, 4);
+    message.replace(24, 8, "TEST    ");
+    put_big_endian(&message[32], price_of(sequence), 4);
+    return message;
+}
+
+void write_rows(TickCaptureWriter& writer, uint64_t first, uint64_t count) {
+    for (uint64_t sequence = first; sequence < first + count; sequence++) {
+        std::string message = make_add_order(sequence);
+
+        // The test wants every row, so wait out a full queue instead of dropping
+        while (!writer.submit(sequence, message)) {
+            writer.publish();
+            std::this_thread::yield();
+        }
+
+        writer.publish();
+    }
+}
+
+std::vector<uint64_t> scan(const TickCaptureReader& reader, std::string_view column) {
+    std::vector<uint64_t> values;
+
+    for (const TickColumnChunk& chunk : reader.get_chunks('A', column)) {
+        decode_tick_column(chunk, values);
+    }
+
+    return values;
+}
+
+// The capture must hold add orders 1..n for some n >= min_rows, every price matching
+bool check_prefix(const char* path, uint64_t min_rows, uint64_t max_rows, const char* what) {
+    TickCaptureReader reader(path);
+    std::vector<uint64_t> sequences = scan(reader, "sequence");
+    std::vector<uint64_t> prices = scan(reader, "price");
+
+    std::cout << what << ": " << sequences.size() << " rows\n";
+
+    if (sequences.size() < min_rows || sequences.size() > max_rows || prices.size() != sequences.size()
+        || reader.get_row_count('A') != sequences.size()) {
+        std::cerr << "FAIL: " << what << ": " << sequences.size() << " sequences, " << prices.size()
+                  << " prices, expected " << min_rows << " to " << max_rows << "\n";
+        return false;
+    }
+
+    for (size_t i = 0; i < sequences.size(); i++) {
+        if (sequences[i] != i + 1 || prices[i] != price_of(i + 1)) {
+            std::cerr << "FAIL: " << what << ": row " << i << " holds sequence " << sequences[i]
+                      << " and price " << prices[i] << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string pid = std::to_string(getpid());
+    std::string closed_path = directory / ("tick_capture_test_closed_" + pid);
+    std::string cut_path = directory / ("tick_capture_test_cut_" + pid);
+    std::string killed_path = directory / ("tick_capture_test_killed_" + pid);
+    bool ok = true;
+
+    try {
+        // Several chunks per column and several flushes, so several footers
+        TickCaptureConfig config;
+        config.path = closed_path;
+        config.chunk_rows = 4096;
+
+        TickCaptureWriter writer(config);
+        write_rows(writer, 1, ROW_COUNT);
+        writer.close();
+
+        ok &= check_prefix(closed_path.c_str(), ROW_COUNT, ROW_COUNT, "closed");
+
+        // A flush that got as far as some of its chunk bytes: the previous flushes are intact
+        std::filesystem::copy_file(closed_path, cut_path, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(cut_path, std::filesystem::file_size(cut_path) + 5000);
+        ok &= check_prefix(cut_path.c_str(), ROW_COUNT, ROW_COUNT, "partial flush appended");
+
+        // The last trailer itself torn off: falls back to the flush before it
+        std::filesystem::copy_file(closed_path, cut_path, std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(cut_path, std::filesystem::file_size(cut_path) - 4);
+        ok &= check_prefix(cut_path.c_str(), 1, ROW_COUNT - 1, "last trailer torn");
+    } catch (const std::exception& e) {
+        std::cerr << "FAIL: " << e.what() << "\n";
+        ok = false;
+    }
+
+    // Killed while writing: flush every millisecond so the kill likely lands mid-flush
+    pid_t child = fork();
+
+    if (child == 0) {
+        TickCaptureConfig config;
+        config.path = killed_path;
+        config.chunk_rows = 512;
+        config.flush_interval = std::chrono::milliseconds(1);
+
+        TickCaptureWriter writer(config);
+
+        for (uint64_t sequence = 1;; sequence += 1000) {
+            write_rows(writer, sequence, 1000);
+        }
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+
+    try {
+        ok &= check_prefix(killed_path.c_str(), 0, UINT64_MAX, "killed writer");
+    } catch (const std::exception& e) {
+        std::cerr << "FAIL: killed writer: " << e.what() << "\n";
+        ok = false;
+    }
+
+    std::filesystem::remove(closed_path);
+    std::filesystem::remove(cut_path);
+    std::filesystem::remove(killed_path);
+
+    return ok ? 0 : 1;
+}